@@ -3,47 +3,51 @@
 #define PRECOMPUTEDMOVEDATA_H
 
 #include "bits.h"
+#include <array>
 #include <cstdint>
 
 class PrecomputedMoveData {
 public:
+    template <typename T, size_t N>
+    using SquareTable = std::array<std::array<T, N>, 64>;
+
     // ---------------- Static Bitboards ----------------
-    static U64 blankPawnMoves[64][2];    // [square][white=0/black=1]
-    static U64 fullPawnAttacks[64][2];   // [square][white=0/black=1]
-    static U64 blankKnightAttacks[64];
-    static U64 blankKingAttacks[64];
-
-    static SMasks blankBishopAttacks[64][2]; // lower, upper, lineEx=lower|upper // direction
-    static SMasks blankRookAttacks[64][2]; // lower, upper, lineEx=lower|upper // direction
-    static SMasks blankQueenAttacks[64][4]; // bishop | rook // direction
+    // all tables are generated at compile time (see PrecomputedMoveData.cpp)
+    static const SquareTable<U64, 2> blankPawnMoves;    // [square][white=0/black=1]
+    static const SquareTable<U64, 2> fullPawnAttacks;   // [square][white=0/black=1]
+    static const std::array<U64, 64> blankKnightAttacks;
+    static const std::array<U64, 64> blankKingAttacks;
+
+    static const SquareTable<SMasks, 2> blankBishopAttacks; // lower, upper, lineEx=lower|upper // direction
+    static const SquareTable<SMasks, 2> blankRookAttacks; // lower, upper, lineEx=lower|upper // direction
+    static const SquareTable<SMasks, 4> blankQueenAttacks; // bishop | rook // direction
     
 
-    static U64 passedPawnMasks[64][2];   // [square][white/black]
+    static const SquareTable<U64, 2> passedPawnMasks;   // [square][white/black]
 
-    static U64 rayMasks[64][64];         // line connecting square_a -> square_b
-    static U64 alignMasks[64][64];       // line including a & b
+    static const SquareTable<U64, 64> rayMasks;         // line connecting square_a -> square_b
+    static const SquareTable<U64, 64> alignMasks;       // line including a & b
 
-    static int distToEdge[64][8];        // square, direction (N,NE,E,...)
-    static int kingMoveDistances[64][64]; // Chebyshev (king moves)
+    // squares strictly between a and b (0 if not aligned)
+    static U64 between(int a, int b) { return rayMasks[a][b] & ~((1ULL << a) | (1ULL << b)); }
 
-    // ---------------- Initialization -----------------
-    // Call once at program startup
-    static void init();
+    static const SquareTable<int, 8> distToEdge;        // square, direction (N,NE,E,...)
+    static const SquareTable<int, 64> kingMoveDistances; // Chebyshev (king moves)
 
 private:
-    // Internal helpers to generate the arrays
-    static void generateFullPawnMoves();
-    static void generateFullPawnAttacks();
-    static void generateBlankKnightAttacks();
-    static void generateBlankBishopAttacks();
-    static void generateBlankRookAttacks();
-    static void generateBlankQueenAttacks();
-    static void generateBlankKingAttacks();
-    static void generatePassedPawnsMasks();
-    static void generateKingDistances();
-    static void generateAlignMasks();
-    static void generateRayMasks();
-    static void generateDistToEdge();
+    // Internal helpers to generate the arrays (constexpr, only evaluated by the compiler)
+    static constexpr SquareTable<U64, 2> generateFullPawnMoves();
+    static constexpr SquareTable<U64, 2> generateFullPawnAttacks();
+    static constexpr std::array<U64, 64> generateBlankKnightAttacks();
+    static constexpr SquareTable<SMasks, 2> generateBlankBishopAttacks();
+    static constexpr SquareTable<SMasks, 2> generateBlankRookAttacks();
+    static constexpr SquareTable<SMasks, 4> generateBlankQueenAttacks();
+    static constexpr std::array<U64, 64> generateBlankKingAttacks();
+    static constexpr SquareTable<U64, 2> generatePassedPawnsMasks();
+    static constexpr SquareTable<int, 64> generateKingDistances();
+    static constexpr SquareTable<U64, 64> generateAlignMasks();
+    static constexpr SquareTable<U64, 64> generateRayMasks();
+    static constexpr SquareTable<int, 8> generateDistToEdge();
 
     // Prevent instance creation
     PrecomputedMoveData() = delete;
@@ -56,6 +56,8 @@ public:
 
     // rank
     static constexpr U64 mask_rank_2 = 0x000000000000FF00ULL;
+    static constexpr U64 mask_rank_3 = 0x0000000000FF0000ULL;
+    static constexpr U64 mask_rank_6 = 0x0000FF0000000000ULL;
     static constexpr U64 mask_rank_7 = 0x00FF000000000000ULL;
 
     // colors masks
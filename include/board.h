@@ -3,9 +3,12 @@
 
 #include "move.h"
 #include "gamestate.h"
+#include "position.h"
 #include "zobrist.h"
 #include "stats.h"
 #include "timer.h"
+#include "fixed_stack.h"
+#include "packed_position.h"
 //#include "NNUE.h"
 
 /**
@@ -14,51 +17,25 @@
  *        castling rights, en-passant square, Zobrist hash, and move history.
  *
  * The board can be initialized from a FEN string or a default starting position.
- * Moves can be made/unmade with MakeMove/UnmakeMove, updating the internal state.
+ * The searchable state lives in the Position base: MakeMove snapshots it onto positionHistory
+ * and then updates incrementally, UnmakeMove restores the snapshot.
  */
-class Board {
+class Board : public Position {
 public:
-    // ==================== Bitboards ====================
-    U64 colorBitboards[2];   ///< [0] = white, [1] = black
-    U64 pieceBitboards[6];   ///< 0=pawn, 1=knight, 2=bishop, 3=rook, 4=queen, 5=king
-    int sqToPiece[64];       ///< Maps square to piece index (0..11), -1 if empty
-
-    // ==================== Game state ====================
-    GameState currentGameState;          ///< Tracks castling, en-passant, fifty-move counter
     std::string fen;                     ///< Current board FEN
-    int plyCount;                        ///< Number of half-moves played
-    bool is_white_move;                  ///< True if white to move
-    int move_color;                      ///< 0=white, 1=black
-    bool is_in_check;                    ///< True if the side to move is in check
-    bool pawn_endgame = false;          ///< True if only kings and pawns remain (for quick NMP verification)
 
     // ==================== Move & position history ====================
-    std::vector<Move> allGameMoves;            ///< All moves played
-    std::vector<GameState> gameStateHistory;  ///< Game state history for unmaking moves
-    std::unordered_map<U64,int> hash_history; ///< Zobrist hash occurrences for repetition detection
-    std::vector<U64> zobrist_history;
-
-    // ==================== Castling trackers ====================
-    bool white_castled = false; ///< True if white has castled
-    bool black_castled = false; ///< True if black has castled
-
-    // ==================== Zobrist hashing ====================
-    U64 zobrist_hash;                ///< Current Zobrist hash
-    U64 zobrist_table[12][64];       ///< Zobrist keys for 12 pieces x 64 squares
-    // piece is encoded as follows
-    // b-p = 0, w-p = 1, b-n = 2, w-n = 3, ... etc (black even, white odd .. incr val)
-    U64 zobrist_side_to_move;        ///< Side to move key
-    U64 zobrist_castling[4];         ///< Castling rights keys: KQkq
-    U64 zobrist_enpassant[8];        ///< En passant file keys: a-h
-
-    // -- polyglot book --
-    //U64 polyglot_hash;                ///< Current Zobrist hash
-    //U64 polyglot_table[12][64];       ///< Zobrist keys for 12 pieces x 64 squares
-    // piece is encoded as follows
-    // b-p = 0, w-p = 1, b-n = 2, w-n = 3, ... etc (black even, white odd .. incr val)
-    //U64 polyglot_side_to_move;        ///< Side to move key
-    //U64 polyglot_castling[4];         ///< Castling rights keys: KQkq
-    //U64 polyglot_enpassant[8];        ///< En passant file keys: a-h
+    // inline fixed-capacity stacks, push on make / pop on unmake (~230 KB per Board, ~680 KB for an
+    // Engine's two: keep Boards and their owners on the heap, not on the main / worker thread stacks)
+    // bound: a game board trims the oldest half once full (MakeMove / MakeNullMove), and a search
+    // clone starts empty and never goes deeper than MAX_PLY (negamax / quiescence ply guard)
+    static constexpr int MAX_HISTORY = MAX_GAME_PLY + MAX_PLY;
+    FixedStack<Move, MAX_HISTORY> allGameMoves;           ///< All moves played on this board
+    FixedStack<Position, MAX_HISTORY> positionHistory;    ///< Position before each move (copy-make undo)
+    FixedStack<U64, MAX_HISTORY> keyHistory;              ///< Zobrist keys for repetition detection, back() = current position
+    // keys played before a cloneForSearch() - owned by the game board and shared, not copied
+    const U64* prefixKeys = nullptr;
+    int prefixCount = 0;
 
     // ==================== NNUE ====================
     //NNUE* nnue; // optional pointer ... allows incremental updates
@@ -66,7 +43,9 @@ public:
 
     // ==================== Constructors ====================
     Board(std::string _fen = STARTPOS_FEN); ///< Initialize from FEN
-    Board(const Board& other); // deep copy search->game boards
+    Board(const Board& other); // full copy (live history only)
+    Board& operator=(const Board& other);
+    void cloneForSearch(const Board& game); // same position, game history shared instead of copied
 
     // ==================== Move execution ====================
     void MakeMove(Move move = false);               ///< Apply a move and update board state
@@ -89,36 +68,52 @@ public:
     int kingSquare(bool white) const;
 
     // ==================== Special move checks ====================
-    bool canEnpassantCapture(int epFile) const; ///< Checks if en-passant is possible
+    bool canEnpassantCapture(int epFile, int side) const; ///< A pawn of side stands next to the pawn that just double-pushed on epFile
     void updateFiftyMoveCounter(int moved_piece, bool isCapture);
-    bool isThreefold();
+    bool isThreefold() const;               ///< Current position occurred 3 times (game rule)
+    bool isRepetition(int ply) const;       ///< Search rule: any repeat after the root (ply plies back), else threefold
 
     // ==================== Board state checks ====================
-    bool inCheck(bool init); ///< True if the given side is in check
+    bool inCheck(bool init); ///< True if the given side is in check (from scratch - search reads is_in_check / checkers)
 
     // ==================== FEN handling ====================
     void setFromFEN(std::string _fen); ///< Initialize board from FEN
     void setBoardFEN();                 ///< Generate FEN string from current state
     std::string getBoardFEN();          ///< Return current board FEN
 
+    // ==================== Packed encoding ====================
+    PackedPosition pack() const;                ///< 32-byte canonical encoding (layout in packed_position.h)
+    bool unpack(const PackedPosition& packed);  ///< Load a packed position (history reset), false + board untouched if malformed
+
     // ==================== Zobrist helper functions ====================
-    U64 randomU64();                           ///< Generate random 64-bit number
-    void initZobristKeys();                    ///< Initialize Zobrist keys
-    U64 computeZobristHash();                  ///< Compute current Zobrist hash
-    U64 zobristCastlingHash(int castling_rights); ///< Hash from castling rights
+    U64 computeZobristHash() const;            ///< Compute current Zobrist hash from the bitboards
+    U64 computeMaterialKey() const;            ///< Compute materialKey (packed piece counts) from the bitboards
+    U64 computePawnKey() const;                ///< Compute pawnKey from the pawn bitboard
     void auditZobrist(const Board &other, const std::string &label = "") const;
     void debugZobristDifference(uint64_t old_hash, uint64_t new_hash);
     void print_zobrist_history(int ply, const std::string& move_str);
     bool canEPCapture(); // check if ep is legal when possible - zobrist 
     bool isEpHashable(int epFile, bool stmIsWhite) const; // incremental version
-    // polyglot
-    //void initPolyglotKeys();                    ///< Initialize Zobrist keys
-    //U64 computePolyglotHash();                  ///< Compute current Zobrist hash
-    //U64 polyglotPieceHash(int piece, int color); // color^1 + 2*piece
-    //U64 polyglotCastlingHash(int castling_rights); ///< Hash from castling rights
+
+    // ==================== Key history ====================
+    // key i plies before the current position, continuing into the shared game prefix
+    U64 keyAt(int i) const {
+        int n = keyHistory.size();
+        return i < n ? keyHistory[n - 1 - i] : prefixKeys[prefixCount - 1 - (i - n)];
+    }
+    int keyDepth() const { return keyHistory.size() + prefixCount; }
 
     // ==================== Debug ====================
     void print_board(); ///< Pretty-print board with FEN and additional info
+    bool validate(std::string* error = nullptr) const; ///< Full consistency check (bitboards, mailbox, hash, cached state), reason in error
+
+private:
+    void copyState(const Board& other); ///< everything but the history stacks
+    void resetHistory();                ///< empty move / position / key history (new root position)
+    void finishSetup();                 ///< derived state (kings, check info, keys) after pieces + game state are loaded
+    void trimHistory();                 ///< drop the oldest half of the history when a game outgrows it
+    void updateCheckInfo();             ///< checkers / blockersForKing into currentGameState
+    void checkConsistency(const char* where); ///< DEBUG builds: validate() after make/unmake, dump + assert on failure
 };
 
 #endif // BOARD_H
@@ -15,8 +15,13 @@
 #include "game_log.h"
 #include "NNUE.h"
 #include "book.h"
+#include "perft.h"
 
 #include <filesystem>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class Searcher;
 struct SearchLimits;
@@ -54,7 +59,7 @@ struct GameTracker {
 
 struct SearchSettings {
     int depth = 0;         // max depth (0 = no limit besides global engine limit)
-    int nodes = 0;         // max nodes
+    uint64_t nodes = 0;    // max nodes (0 = no limit)
     int movetime = 0;      // fixed search time (ms)
     int mate = 0;          // search for mate in N
     int wtime = 0;         // white time left (ms)
@@ -65,6 +70,7 @@ struct SearchSettings {
     bool infinite = false; // search until "stop"
     bool ponder = false;   // pondering search
     bool send_eval = false; // send evaluation instead of move
+    std::vector<std::string> searchmoves; // root moves to consider (uci strings, empty = all)
 };
 
 struct EngineOptions {
@@ -72,6 +78,7 @@ struct EngineOptions {
     int  MAX_THREADS      = 1;
     int  HASH_SIZE_MB     = 512;
     bool PONDERING        = false;
+    int  MULTI_PV         = 1;
     bool UCI_SHOW_WDL     = false;
 
     fs::path opening_pst_path  = fs::path(PROJECT_ROOT) / "bin/pst/pst_opening.txt";
@@ -81,6 +88,8 @@ struct EngineOptions {
     fs::path syzygy_path       = fs::path(PROJECT_ROOT);
 };
 
+inline constexpr int BENCH_DEPTH = 8; // default depth of the bench command
+
 // ------------------
 // -- Engine Class --
 // ------------------
@@ -100,8 +109,16 @@ public:
     SearchSettings settings;
     SearchLimits limits;
 
+    // search thread: go returns at once, the worker sends bestmove
+    std::thread search_thread;
+    std::atomic<bool> stop_requested{false};
+    // a finished go infinite / go ponder search sleeps here until stop or ponderhit
+    std::mutex bestmove_mutex;
+    std::condition_variable bestmove_cv;
+
     // constructors
     Engine();
+    ~Engine();
 
     // search + eval
     std::unique_ptr<Searcher> searcher;
@@ -112,6 +129,10 @@ public:
     // boards
     Board game_board;        // main game board
     Board search_board;       // modifable copy of game board for searcher
+    // last position command as applied to game_board (the next one only plays what it appends)
+    std::string position_fen;
+    std::vector<std::string> position_moves;
+    U64 position_key = 0;     // game_board key after those moves - any other change forces a full reset
     bool game_over = false;
 
     // movegen for current move
@@ -124,10 +145,12 @@ public:
     Move bestMove = Move::NullMove();
     int bestEval = -MATE_SCORE;
     std::vector<Move> pv_line;
+    std::string info_buffer; // UCI info output, reused (search thread only)
+    static constexpr size_t INFO_BUFFER_RESERVE = 16 * 1024;
 
     // think on opponent time
-    bool pondering = false;
-    Move ponderMove = Move::NullMove();
+    std::atomic<bool> pondering{false};      // go ponder until ponderhit / stop (set and cleared by the UCI thread)
+    Move ponderMove = Move::NullMove();      // second PV move, sent with bestmove
 
     // --- State ---
     void clearState();
@@ -135,15 +158,19 @@ public:
     // --- UCI Handlers ---
     void setOption(const std::string& name, const std::string& value);
     void setPosition(const std::string& fen, const std::vector<std::string>& uci_moves);
+    void applyUCIMove(const std::string& uci_move); // uci string -> flagged Move on game_board
     void ponderHit();
-    void print_info();
+    void print_info(const SearchResult& res, int depth, const SearchLimits& lim); // info line(s) for a completed iteration
+    void print_progress(const SearchLimits& lim);                                 // periodic info while an iteration runs
 
     // --- Search  ---
     void startSearch();
+    void startSearchThread(bool send_eval = false); // run startSearch + sendBestMove on search_thread
+    void waitForSearch();                           // join the search thread (no-op when idle)
     void stopSearch();
     void computeSearchTime(const SearchSettings& settings); // defines the settings for it_dp
     //  Result
-    void sendBestMove(Move bestMove, bool eval = false, bool ponder = false); // output of it_dp
+    void sendBestMove(Move bestMove, bool eval = false); // output of it_dp (+ ponder move when the PV has one)
 
     // --- Games ---
     void newGame();
@@ -157,12 +184,15 @@ public:
 
     // --- Tests ---
     uint64_t perft(int depth);
-    void perftPrint(int depth); // same as perft but print instead of return
-    void perftDivide(int depth);
+    void perftPrint(int depth, int threads = 0, size_t hash_mb = 64); // fast perft (bulk count, hash, threaded root split)
+    void perftDivide(int depth, int threads = 0, size_t hash_mb = 64);
+    void perftSuite(const fs::path& file, const PerftSuiteSettings& settings = {});
     void SEETest(int capture_square);
     void staticEvalTest();
     void nnueEvalTest();
     void moveOrderingTest(int depth);
+    void bench(int depth = BENCH_DEPTH); // fixed-depth search over a fixed position set: total nodes + nps
+    bool selfTest();                     // built-in regression checks, one ok / FAILED line each
 
     // --- Config ---
     void apply_config_file(const fs::path& path);
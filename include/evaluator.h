@@ -95,6 +95,22 @@ struct TaperedEvalReport {
 };
 
 
+// =================== Pawn Hash ===================
+// pawn-only terms keyed by Board::pawnKey, plus the king-shield terms for the king squares
+// they were last computed for (refreshed on probe when a king moves)
+struct PawnEntry {
+    U64 key = 0;
+    U64 passed[2] = {0ULL, 0ULL}; // passed pawns [white, black]
+    int16_t structure = 0;        // pawnStructureDifferences (doubled + isolated, white - black)
+    int16_t passedScore = 0;      // pawn-only part of passedPawnDifferences (rank + protection, white - black)
+    int16_t shield[2] = {0, 0};   // kingShield per side
+    int16_t openFiles[2] = {0, 0};// openFilesNearKing per side
+    int8_t kingSq[2] = {-1, -1};  // king squares shield / openFiles belong to
+    bool filled = false;
+};
+
+constexpr size_t PAWN_HASH_ENTRIES = 1 << 14; // power of two
+
 // =================== Evaluator ===================
 class Evaluator {
 private:
@@ -132,6 +148,11 @@ public:
     int SEE(const Board& board, const Move& move);
     U64 attackersTo(const Board& board, int sq, bool white, U64 occ);
 
+    // Pawn hash
+    std::vector<PawnEntry> pawnTable = std::vector<PawnEntry>(PAWN_HASH_ENTRIES);
+    PawnEntry& probePawns(const Board& board);
+    void clearPawnTable();
+
     // Pawn helpers
     int countDoubledPawns(U64 pawns);
     int countIsolatedPawns(U64 pawns);
@@ -0,0 +1,62 @@
+// fixed_stack.h
+// Inline fixed-capacity stack with the vector calls the board history uses
+// (push_back / pop_back / back / size / operator[]) - no heap traffic on make/unmake.
+// Copies only move the live elements, not the whole capacity.
+// The capacity is checked in every build: an overflow aborts instead of writing past items[].
+
+#ifndef FIXED_STACK_H
+#define FIXED_STACK_H
+
+#include "helpers.h"
+#include <cstdio>
+
+template <typename T, int N>
+class FixedStack {
+public:
+    FixedStack() = default;
+    FixedStack(const FixedStack& other) : n(other.n) { std::copy_n(other.items, n, items); }
+    FixedStack& operator=(const FixedStack& other) {
+        n = other.n;
+        std::copy_n(other.items, n, items);
+        return *this;
+    }
+
+    void push_back(const T& value) {
+        if (n >= N) overflow();
+        items[n++] = value;
+    }
+    void pop_back() { assert(n > 0); n--; }
+    void clear() { n = 0; }
+
+    T& back() { return items[n - 1]; }
+    const T& back() const { return items[n - 1]; }
+    T& operator[](int i) { return items[i]; }
+    const T& operator[](int i) const { return items[i]; }
+
+    int size() const { return n; }
+    bool empty() const { return n == 0; }
+    bool full() const { return n == N; }
+    static constexpr int capacity() { return N; }
+
+    T* data() { return items; }
+    const T* data() const { return items; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + n; }
+
+    // discard the k oldest entries (keeps the newest n-k in order)
+    void drop_front(int k) {
+        std::copy(items + k, items + n, items);
+        n -= k;
+    }
+
+private:
+    [[noreturn]] static void overflow() {
+        std::fprintf(stderr, "FixedStack overflow (capacity %d)\n", N);
+        std::abort();
+    }
+
+    T items[N];
+    int n = 0;
+};
+
+#endif
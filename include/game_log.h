@@ -29,7 +29,8 @@ enum class GameEndReason {
 struct GameLog {
     bool finalized = false;
 
-    int nodes, movetime, depth = 0;
+    uint64_t nodes = 0;
+    int movetime, depth = 0;
     int wtime, btime, winc, binc, movestogo = 0;
 
     std::string startFEN;
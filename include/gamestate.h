@@ -5,15 +5,25 @@
 #ifndef GAMESTATE_H
 #define GAMESTATE_H
 
+#include "helpers.h"
+
 struct GameState {
 private:
 public:
-    // additional state information
-    int capturedPieceType;
-    int enPassantFile;
-    int fiftyMoveCounter;
-    int castlingRights;
+    // additional state information (narrow types: copied with every Position snapshot,
+    // ordered so the small fields pack into one 8-byte word)
+    int16_t fiftyMoveCounter;
+    int8_t capturedPieceType;
+    int8_t enPassantFile;
+    int8_t castlingRights;
+    int8_t kingSquare[2];   // [white, black], kept up to date by MovePiece
+    uint8_t pliesFromNull;  // plies since the last null move (or setFromFEN), saturates at 255 - repetition scans stop here
     //bool was_in_check;
+
+    // check info, computed once per make (unmake restores it with the snapshot)
+    U64 checkers;           // opponent pieces giving check to the side to move
+    U64 blockersForKing[2]; // pieces (either color) that are the only piece between a slider and king [c]
+                            // (pinned pieces of c = blockersForKing[c] & own pieces)
     
     // remove bits
     static constexpr int clearWhiteKingSideMask = 0b1110;
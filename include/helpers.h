@@ -38,6 +38,9 @@ inline constexpr int  MATE_SCORE            = 100'000;
 inline constexpr int  KILL_SEARCH_RETURN    = -5 * MATE_SCORE;
 inline constexpr int  MAX_MOVES             = 256;
 inline constexpr int  MAX_DEPTH             = 32;
+inline constexpr int  MAX_GAME_PLY          = 1024;   // history capacity for played moves
+inline constexpr int  MAX_PLY               = 128;    // search plies on top of the game (incl. quiescence)
+inline constexpr int  MATE_IN_MAX_PLY       = MATE_SCORE - MAX_PLY; // |eval| at or above this is a mate score
 
 // board squares
 enum {
@@ -105,15 +108,15 @@ inline std::string generate_uuid() {
 }
 
 // set/get/pop macros
-inline void set_bit(U64& bitboard, int square) {
+constexpr void set_bit(U64& bitboard, int square) {
     bitboard |= (1ULL << square);
 }
 
-inline int get_bit(U64 bitboard, int square) {
+constexpr int get_bit(U64 bitboard, int square) {
     return (bitboard >> square) & 1;
 }
 // Inline function to pop the bit for a given square
-inline void pop_bit(U64 &bitboard, int square) {
+constexpr void pop_bit(U64 &bitboard, int square) {
     bitboard &= ~(1ULL << square);
 }
 
@@ -2,25 +2,21 @@
 #define MAGICS_H
 
 #include "helpers.h"
+#include <array>
 
 namespace Magics {
-    extern U64 rookAttackTable[64][4096]; // precompute and store
-    extern U64 bishopAttackTable[64][512];
-    extern U64 rookMasks[64];
-    extern U64 bishopMasks[64];
-    extern U64 rookMagics[64];
-    extern U64 bishopMagics[64];
-    extern int rookShifts[64];
-    extern int bishopShifts[64];
+    // generated at compile time in magics.cpp
+    extern const std::array<std::array<U64, 4096>, 64> rookAttackTable;
+    extern const std::array<std::array<U64, 512>, 64> bishopAttackTable;
+    extern const std::array<U64, 64> rookMasks;
+    extern const std::array<U64, 64> bishopMasks;
+    extern const std::array<U64, 64> rookMagics;
+    extern const std::array<U64, 64> bishopMagics;
+    extern const std::array<int, 64> rookShifts;
+    extern const std::array<int, 64> bishopShifts;
 
-    void initMagics(); // call at engine startup
-    U64 maskRook(int sq);
-    U64 maskBishop(int sq);
-    std::vector<U64> generateAllOccupancies(U64 mask);
-    U64 rookAttacksOnTheFly(int sq, U64 blockers);
-    U64 bishopAttacksOnTheFly(int sq, U64 blockers);
     U64 rookAttacks(int sq, U64 occ);
     U64 bishopAttacks(int sq, U64 occ);
 }
 
-#endif
\ No newline at end of file
+#endif
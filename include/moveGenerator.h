@@ -1,6 +1,10 @@
 // MoveGenerator.h
-// Responsible for generating pseudo-legal and legal chess moves, including sliding moves,
+// Responsible for generating legal chess moves, including sliding moves,
 // knight moves, king moves, pawn moves, captures, checks, pins, and en-passant legality.
+//
+// Generation is templated on the side to move and the generation type, so every
+// (color, type) pair compiles to its own straight-line code. The opponent is never
+// "move generated" - its attacks come from a dedicated attack-map routine.
 
 #ifndef MOVEGENERATOR_H
 #define MOVEGENERATOR_H
@@ -11,6 +15,12 @@
 #include "move.h"
 #include "board.h"
 
+// what to generate
+//      ALL      - every legal move
+//      CAPTURES - captures (incl. en-passant) and all promotions (quiescence set)
+//      QUIETS   - non-capturing, non-promoting moves (incl. castling)
+//      EVASIONS - every legal move while in check
+enum GenType { ALL, CAPTURES, QUIETS, EVASIONS };
 
 class MoveGenerator {
 public:
@@ -37,49 +47,30 @@ public:
     // ------------------------
     // Public Move Generation
     // ------------------------
-    // single pass full generation
+    // single pass full generation (quiescence -> CAPTURES, in check -> EVASIONS)
     int generateMoves(const Board& _board, bool _quiescence);
-    // quiescence limited generation (check-evasions, captures, promotions, limited quiet moves)
-    // Check if side has any legal moves (accelerated generation)
+    // typed generation, dispatches on the side to move
+    template <GenType Type>
+    int generate(const Board& _board);
+    // legal move count without writing moves (perft leaves, game end)
+    int countLegalMoves(const Board& _board);
+    // Check if side has any legal moves (stops at the first one)
     bool hasLegalMoves(const Board& _board);
-    // classic move generation method
-    //U64 odiff(U64 occ, SMasks pMask);
+    // same, reusing the position loaded by the last generateMoves/generate call
+    bool hasLegalMoves();
 
     // ------------------------
-    // Individual Piece Move Generators
-    // ------------------------
-    void generateSlidingMoves(bool ours); // magic bitboards
-    void generateKnightMoves(bool ours);
-    void generatePawnPushes(bool ours);
-    void generatePawnAttacks(bool ours);
-    void generatePromotions(int start_square, int target_square);
-    void generateKingMoves(bool ours);
-
+    // Attack Maps
     // ------------------------
-    // Pins & En-passant
-    // ------------------------
-    bool isPinned(int square);
-    bool isEnpassantPinned(int start_square, int target_file);
+    // every square attacked by Color given the occupancy (branch-free per piece set)
+    template <int Color>
+    static U64 attackMap(const Board& board, U64 occ);
 
     // ------------------------
     // Move Classification
     // ------------------------
-    bool shouldAddMove(const Move& move) const;
     bool isCheck(const Move move); // legal only (all - including discovered)
 
-    // ------------------------
-    // Bitboard Updates/Helpers
-    // ------------------------
-    void updateBitboards(const Board& board);
-    // move restrictions based on board state
-    U64 limitPinnedMoves(int square, U64 moves_bb);
-    U64 restrictCheckMoves(U64 moves_bb);
-    // bitboards -> moves list
-    void addMovesFromBitboard(int start_square, U64 moves_bb, int flag=0);
-    bool isPromotionPawn(int square);
-    // opponent attack information
-    void updateAttackMapAndCheck(U64 attacks_bb, bool ours, int start_square, int piece_type = -1);
-
     // ------------------------
     // Board & State References
     // ------------------------
@@ -96,18 +87,41 @@ public:
     bool in_check = false;
     bool in_double_check = false;
 
-    // Mask boards for checks, pins, and attacks
-    U64 check_ray_mask = 0ULL;
-    U64 check_ray_mask_ext = 0ULL;
-    U64 pin_rays = 0ULL;
-    U64 opponentAttackMap = 0ULL;
-    U64 ownAttackMap = 0ULL;
-
-    // Post-en-passant attack maps for legality checks
-    U64 postEnpassantOpponentAttackMap = 0ULL;
-    U64 enPassantMaskBlockers = 0ULL;
+    U64 checkers = 0ULL;            // opponent pieces giving check
+    U64 pinned = 0ULL;              // own pieces pinned to own king
+    U64 opponentAttackMap = 0ULL;   // computed with own king removed (no stepping back along a ray), not built by hasLegalMoves
 
 private:
+    // ------------------------
+    // Bitboard Updates/Helpers
+    // ------------------------
+    void updateBitboards(const Board& board, bool with_attack_map = true);
+    template <int Us>
+    void updateCheckInfo(const Board& board, bool with_attack_map);
+    bool isAttacked(int sq, U64 occ) const; // by the opponent
+    template <int Us>
+    bool anyLegalMove();
+
+    // ------------------------
+    // Individual Piece Move Generators
+    // ------------------------
+    // CountOnly: only bump `count`, never write the move list
+    template <int Us, GenType Type, bool CountOnly = false>
+    void generateAll();
+    template <int Us, GenType Type, bool CountOnly>
+    void generatePawnMoves(U64 pawns_bb, U64 target);
+    template <int Us, GenType Type, bool CountOnly>
+    void generateEnPassant();
+    template <int Us, int Pt, bool CountOnly>
+    void generatePieceMoves(U64 target);
+    template <int Us, GenType Type, bool CountOnly>
+    void generateKingMoves();
+    template <int Us, GenType Type, bool CountOnly>
+    void generateCastles();
+
+    // bitboards -> moves list
+    void addMovesFromBitboard(int start_square, U64 moves_bb, int flag=0);
+    void addPromotions(int start_square, int target_square);
 };
 
 #endif
@@ -0,0 +1,68 @@
+// packed_position.h
+// Canonical 32-byte binary position for datasets and caches (instead of FEN strings).
+//
+// bytes  0..7   occupancy bitboard, little-endian
+// bytes  8..23  one nibble per occupied square in ascending square order (low nibble first),
+//               value = sqToPiece index (0..5 white P..K, 6..11 black)
+// byte   24     bit 0 side to move (1 = black), bits 1..4 castling rights (GameState layout,
+//               a right whose king or rook is off its home square is dropped on unpack)
+// byte   25     en-passant file + 1 (0 = none)
+// byte   26     fifty-move counter (clamped to 255)
+// bytes 28..29  plyCount, little-endian
+// bytes 27, 30, 31 reserved (0)
+//
+// Encode / decode live on Board (pack / unpack) and allocate nothing; the reader / writer
+// below stream flat files of records.
+
+#ifndef PACKED_POSITION_H
+#define PACKED_POSITION_H
+
+#include "helpers.h"
+
+class Board;
+
+struct PackedPosition {
+    static constexpr int SIZE = 32;
+    uint8_t bytes[SIZE] = {};
+
+    bool operator==(const PackedPosition& other) const { return std::memcmp(bytes, other.bytes, SIZE) == 0; }
+    bool operator!=(const PackedPosition& other) const { return !(*this == other); }
+};
+
+static_assert(sizeof(PackedPosition) == PackedPosition::SIZE, "PackedPosition is written to disk as raw bytes");
+
+// -------------------------------
+// Streaming files of packed positions
+// -------------------------------
+class PackedPositionWriter {
+public:
+    explicit PackedPositionWriter(const fs::path& path, bool append = false);
+
+    bool is_open() const { return out.is_open(); }
+    void write(const PackedPosition& packed);
+    void write(const Board& board);
+    void flush() { out.flush(); }
+    size_t count() const { return written; }
+
+private:
+    std::ofstream out;
+    size_t written = 0;
+};
+
+class PackedPositionReader {
+public:
+    explicit PackedPositionReader(const fs::path& path);
+
+    bool is_open() const { return in.is_open(); }
+    bool next(PackedPosition& packed); ///< false at end of file
+    bool next(Board& board);           ///< false at end of file, malformed records are skipped
+    size_t count() const { return records; }
+    size_t rejected() const { return malformed; }
+
+private:
+    std::ifstream in;
+    size_t records = 0;
+    size_t malformed = 0;
+};
+
+#endif
@@ -0,0 +1,83 @@
+// perft.h
+// Fast perft: bulk counting at depth 1, a lockless perft hash keyed by zobrist + depth,
+// and root moves split across threads (each thread owns its board + movegen).
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "helpers.h"
+#include "move.h"
+#include "board.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+
+// -------------------------------
+// Perft hash table
+// -------------------------------
+// data  = nodes << 8 | depth
+// check = key ^ data       (xor trick: a torn write between threads fails the check)
+class PerftTable {
+public:
+    explicit PerftTable(size_t mbSize = 64);
+
+    bool probe(U64 key, int depth, uint64_t& nodes) const;
+    void store(U64 key, int depth, uint64_t nodes);
+    void clear(); // not thread-safe: only between runs
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    std::unique_ptr<Entry[]> table;
+    size_t mask = 0;
+};
+
+// -------------------------------
+// Perft result
+// -------------------------------
+struct PerftResult {
+    uint64_t nodes = 0;
+    uint64_t time_ms = 0;
+    std::vector<std::pair<Move, uint64_t>> divide; // per root move, in generation order
+};
+
+// threads <= 0 uses every hardware thread, hash_mb == 0 disables the perft hash
+PerftResult runPerft(const Board& root, int depth, int threads = 0, size_t hash_mb = 64);
+// same, sharing a caller-owned table (nullptr = no hash) - e.g. across a whole suite
+PerftResult runPerft(const Board& root, int depth, int threads, PerftTable* table);
+
+// -------------------------------
+// Perft suite (EPD: "fen; D1 n; D2 n; ...")
+// -------------------------------
+// defaults time movegen alone: one thread, no perft hash (nps comparable across runs / machines)
+struct PerftSuiteSettings {
+    int max_depth = 0;  // every listed depth <= max_depth (0 = all)
+    int threads = 1;    // root split threads (<= 0 = every hardware thread)
+    size_t hash_mb = 0; // perft hash per position (0 = none)
+};
+
+struct PerftDepthResult {
+    int depth = 0;
+    uint64_t expected = 0;
+    uint64_t nodes = 0;
+    uint64_t time_ms = 0;
+    bool pass = false;
+};
+
+struct PerftSuiteEntry {
+    std::string fen;
+    std::vector<PerftDepthResult> depths;
+    uint64_t nodes = 0;
+    uint64_t time_ms = 0;
+    bool pass = true;
+};
+
+// one jsonl line per position, plus a summary line (type "perft_suite"), both with the settings
+void logPerftEntry(const PerftSuiteEntry& entry, const PerftSuiteSettings& settings);
+void logPerftSummary(const std::string& file, const PerftSuiteSettings& settings, int positions, int passed, uint64_t nodes, uint64_t time_ms);
+
+#endif
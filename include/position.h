@@ -0,0 +1,43 @@
+// position.h
+// The part of the board that search copies: bitboards, mailbox, game state and key.
+// Trivially copyable and small, so MakeMove snapshots it and UnmakeMove is a plain restore
+// instead of reconstructing the moved piece, castling and hash incrementally.
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include "helpers.h"
+#include "gamestate.h"
+#include <type_traits>
+
+struct Position {
+    // ==================== Bitboards ====================
+    U64 colorBitboards[2];   ///< [0] = white, [1] = black
+    U64 pieceBitboards[6];   ///< 0=pawn, 1=knight, 2=bishop, 3=rook, 4=queen, 5=king
+    int8_t sqToPiece[64];    ///< Maps square to piece index (0..11), -1 if empty
+
+    // ==================== Game state ====================
+    GameState currentGameState;          ///< Tracks castling, en-passant, fifty-move counter
+    U64 zobrist_hash;                    ///< Current Zobrist hash (Polyglot-compatible, keys in Zobrist::)
+    U64 materialKey;                     ///< Piece counts, 4 bits each at the sqToPiece index - exact material signature
+    U64 pawnKey;                         ///< Zobrist key of the pawns alone (evaluator pawn hash)
+    int16_t plyCount;                    ///< Number of half-moves played
+    int8_t move_color;                   ///< 0=white, 1=black
+    bool is_white_move;                  ///< True if white to move
+    bool is_in_check;                    ///< True if the side to move is in check
+    bool white_castled = false;          ///< True if white has castled
+    bool black_castled = false;          ///< True if black has castled
+
+    // ==================== Material (O(1) from materialKey) ====================
+    static constexpr U64 materialUnit(int pt12) { return 1ULL << (4 * pt12); }
+    static constexpr U64 NON_PAWN_NIBBLES = 0xFFFF0ULL | (0xFFFF0ULL << 24); // knight..queen of both colors
+
+    int pieceCount(int pt12) const { return static_cast<int>((materialKey >> (4 * pt12)) & 0xF); }
+    int pieceCount(int piece, int side) const { return pieceCount(piece + 6 * side); }
+    bool pawnEndgame() const { return !(materialKey & NON_PAWN_NIBBLES); } ///< Only kings and pawns remain (NMP guard)
+};
+
+static_assert(std::is_trivially_copyable_v<Position>, "Position is copied with memcpy semantics");
+static_assert(sizeof(Position) < 200, "Position should stay small enough to copy every ply");
+
+#endif
@@ -1,37 +1,135 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <functional>
 
 #include "helpers.h"
 
 struct SearchLimits {
-    std::chrono::steady_clock::time_point start_time;
-    int time_limit_ms;
+    std::chrono::steady_clock::time_point start_time;   // search start (go): reported time / nps
+    std::chrono::steady_clock::time_point budget_start; // time / soft limits count from here (ponderhit moves it)
+    int time_limit_ms;                                // hard limit, polled inside the tree (0 = none)
+    int soft_limit_ms = 0;                            // optimum time under a game clock, checked between iterations (0 = none)
     int max_depth = MAX_DEPTH;
-    bool stopped;
+    int mate = 0;                                     // go mate N: done once a mate in <= N moves is proven
+    bool stopped;                                     // latched once a limit or a stop request is seen
+    const std::atomic<bool>* stop_request = nullptr;  // Engine::stop_requested, set by the UCI thread (stop / quit)
+    const std::atomic<bool>* ponder = nullptr;        // Engine::pondering during go ponder: no clock until ponderhit
 
-    SearchLimits(int ms = 0, int depth = -1)
+    uint64_t nodes = 0;                               // nodes entered (negamax + quiescence)
+    uint64_t node_limit = 0;                          // go nodes, 0 = no budget
+    int depth = 0;                                    // iteration in progress
+    int seldepth = 0;                                 // deepest ply entered in this iteration (quiescence included)
+
+    // periodic report while an iteration runs (UCI info without a pv), from the poll
+    std::function<void(const SearchLimits&)> on_progress;
+    static constexpr int64_t PROGRESS_INTERVAL_MS = 1000;
+    int64_t next_progress_ms = PROGRESS_INTERVAL_MS;
+
+    // the clock and the stop flag are read once per POLL_INTERVAL nodes, not at every node
+    static constexpr uint64_t POLL_INTERVAL = 1024;
+    uint64_t next_poll;                               // node count of the next poll (never past node_limit)
+
+    SearchLimits(int ms = 0, int depth_limit = -1, uint64_t max_nodes = 0)
         : start_time(std::chrono::steady_clock::now()),
+          budget_start(start_time),
           time_limit_ms(ms),
-          max_depth(depth < 0 ? MAX_DEPTH : depth),
-          stopped(false) {}
+          max_depth(depth_limit < 0 ? MAX_DEPTH : depth_limit),
+          stopped(false),
+          node_limit(max_nodes),
+          next_poll(max_nodes ? std::min(POLL_INTERVAL, max_nodes) : POLL_INTERVAL) {}
+
+    // once per node: a counter bump, and a real check every POLL_INTERVAL nodes
+    // the node budget lands exactly on a poll, so a node-limited search stops at the same node everywhere
+    // nodes entered while unwinding from a stop are not counted: go nodes N reports exactly N
+    inline void count_node(int ply) {
+        if (stopped) return;
+        if (ply > seldepth) seldepth = ply;
+        if (++nodes >= next_poll) poll();
+    }
+
+    // in-tree checks only read the latched flag (set by poll)
+    inline bool out_of_time() const {
+        return stopped;
+    }
 
-    inline bool out_of_time() {
+    // stop request + node budget + clock
+    inline bool poll() {
         if (stopped) return true;
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed =
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count();
-        if (elapsed >= time_limit_ms && time_limit_ms > 0) {
+        next_poll = nodes + POLL_INTERVAL;
+        if (node_limit) {
+            if (nodes >= node_limit) {
+                stopped = true;
+                return true;
+            }
+            next_poll = std::min(next_poll, node_limit);
+        }
+        if (stop_request && stop_request->load(std::memory_order_relaxed)) {
+            stopped = true;
+            return true;
+        }
+        bool timed = time_limit_ms > 0 && clock_running();
+        if (!timed && !on_progress) return false;
+        if (on_progress) {
+            int64_t elapsed = elapsed_ms();
+            if (elapsed >= next_progress_ms) {
+                next_progress_ms = elapsed + PROGRESS_INTERVAL_MS;
+                on_progress(*this);
+            }
+        }
+        if (timed && budget_elapsed_ms() >= time_limit_ms) {
+            stopped = true;
+            return true;
+        }
+        return false;
+    }
+
+    // pondering: the budget is for our own move, so it starts when ponderhit arrives (the tree is kept)
+    // start_time stays put: info time / nps keep covering every node since go ponder
+    inline bool clock_running() {
+        if (!ponder) return true;
+        if (ponder->load(std::memory_order_relaxed)) return false;
+        ponder = nullptr;
+        budget_start = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    // since go (reporting)
+    inline int64_t elapsed_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    // since the budget started (limits)
+    inline int64_t budget_elapsed_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - budget_start).count();
+    }
+
+    // between iterations under a game clock: stop once the (scaled) optimum is used up,
+    // or when the next iteration is predicted to run into the hard limit anyway
+    inline bool soft_stop(double scale, int64_t next_iteration_ms) {
+        if (soft_limit_ms <= 0 || !clock_running()) return false;
+        int64_t elapsed = budget_elapsed_ms();
+        int64_t optimum = std::min<int64_t>(static_cast<int64_t>(soft_limit_ms * scale), time_limit_ms);
+        if (elapsed >= optimum || elapsed + next_iteration_ms >= time_limit_ms) {
             stopped = true;
             return true;
         }
         return false;
     }
 
+    inline bool mate_found(int eval) const {
+        return mate > 0 && eval >= MATE_SCORE - (2 * mate - 1);
+    }
+
     inline bool depth_reached(int current_depth) {
         return (max_depth >= 0 && current_depth > max_depth);
     }
 
+    // between iterations / aspiration re-searches: always a real check
     inline bool should_stop(int current_depth) {
-        return out_of_time() || depth_reached(current_depth);
+        return poll() || depth_reached(current_depth);
     }
 };
@@ -23,6 +23,20 @@ struct PV {
         line.push_back(first);
         line.insert(line.end(), child.line.begin(), child.line.end());
     }
+    // from the searcher's triangular table (root only)
+    inline void set(Move first, const Move* child, int n) {
+        line.clear();
+        line.reserve(1 + static_cast<size_t>(n));
+        line.push_back(first);
+        line.insert(line.end(), child, child + n);
+    }
+};
+
+inline constexpr int MAX_MULTI_PV = 32; // MultiPV option cap
+
+struct PVLine {
+    int eval = -MATE_SCORE;
+    PV line;
 };
 
 struct SearchResult {
@@ -32,6 +46,11 @@ struct SearchResult {
 
     RootMove root_moves[MAX_MOVES];
     int root_count = 0;
+    int fail_lows = 0; // aspiration fail-low re-searches this iteration (time management)
+
+    // MultiPV: best first, lines[0] is eval / best_line
+    PVLine lines[MAX_MULTI_PV];
+    int line_count = 0;
 
     inline void setPV(Move first, const PV& child) {
         best_line.set(first, child);
@@ -9,6 +9,7 @@
 #include "NNUE.h"
 #include "tt.h"
 #include "moveGenerator.h"
+#include <functional>
 
 class Engine;
 class Evaluator;
@@ -36,6 +37,14 @@ struct SearchParams {
     float R_LMR_DENOM            = 3.14f;  //   = const + [log(depth) * log(move_order)] / denom
     int   LMR_MOVE_ORDER_THRESHOLD = 3; // minimum move order # to start using LMR
     int   LMR_DEPTH_THRESHOLD    = 3; // max search depth where LMR doesnt trigger
+    // time management (game clock): optimum time *= stability * best-move node share * score drop
+    float TM_STABILITY_SCALE[5]  = {2.0f, 1.4f, 1.1f, 0.9f, 0.8f}; // by iterations the best move has held (capped at 4)
+    float TM_NODE_BASE           = 1.3f;   // node scale = (base - best move node fraction) * mult (typical fraction here ~0.15)
+    float TM_NODE_MULT           = 1.0f;
+    int   TM_SCORE_DROP_CAP      = 100;    // score drop (cp) vs the last iteration, counted up to this
+    float TM_SCORE_DROP_SCALE    = 0.005f; // +0.5 at the cap
+    float TM_FAIL_LOW_SCALE      = 0.1f;   // per aspiration fail-low (up to 3)
+    float TM_MAX_EBF             = 8.0f;   // cap on the branching factor used to predict the next iteration
 };
 
 // ---- move ordering priorities ----
@@ -61,6 +70,20 @@ struct RootMoveScores {
     int QUIET_BASE     = 0;
 };
 
+// ---- per-ply search stack ----
+// one entry per ply, written on the way down: children read their parent's entry (ss - 1)
+// instead of taking it as arguments, and ss - 2 gives the same side's previous node
+struct SearchStackEntry {
+    static constexpr int EVAL_NONE = -INF; // static_eval when in check (not computed)
+
+    Move move;              // move made from this node (null move = NMP, blocks a second null move)
+    Move pv_move;           // previous iteration's PV move at this ply (ordering)
+    Move killers[2];        // quiet moves that caused a beta cutoff at this ply (kept across iterations)
+    int  static_eval = EVAL_NONE;
+    int  reduction = 0;     // LMR reduction applied to move
+    bool in_check = false;
+};
+
 class Searcher {
 public:
     // ------------------------------- VARS -------------------------------
@@ -82,13 +105,27 @@ public:
     void store_last_node_counts(const SearchResult& res); // fill node_count_table
     int get_node_count(Move m) const; // retrieve from table
 
+    // time management scale for the last completed iteration (see SearchParams TM_*)
+    double timeScale(const SearchResult& res, int stability, int score_drop) const;
+
     bool stop = false;
+    int multi_pv = 1; // root lines searched with a full window (MultiPV option)
+
+    // called after every completed iteration (UCI info lines), may be empty
+    std::function<void(const SearchResult&, int depth, const SearchLimits&)> on_iteration;
+
+    // search stack, index ply + STACK_OFFSET so the root can look two plies back
+    static constexpr int STACK_OFFSET = 2;
+    SearchStackEntry search_stack[MAX_PLY + STACK_OFFSET + 2];
+    SearchStackEntry* stackAt(int ply) { return &search_stack[ply + STACK_OFFSET]; }
 
-    Move killerMoves[MAX_DEPTH][2] = {};
     int historyHeuristic[12][64] = {};
+    void clearHeuristics(); // killers + history (new game / bench)
 
-    std::vector<Move> best_line;
-    std::vector<Move> best_quiescence_line;
+    // triangular PV table: pv_table[ply] is the best line from ply on (pv_length[ply] moves),
+    // rebuilt from pv_table[ply + 1] when a move improves - no allocation inside the search
+    Move pv_table[MAX_PLY + 2][MAX_PLY + 2];
+    int pv_length[MAX_PLY + 2] = {};
 
     // ------------------------------- FUNCS -------------------------------
 
@@ -103,7 +140,7 @@ public:
     SearchResult iterativeDeepening(
         Move first_moves[MAX_MOVES],
         int move_count,
-        SearchLimits limits
+        SearchLimits& limits
     );
     
     SearchResult search(
@@ -111,26 +148,31 @@ public:
         int move_count,
         int depth,
         SearchLimits& limits,
-        std::vector<Move>& previousPV,
+        const std::vector<Move>& previousPV,
         int previousEval
     );
 
+    SearchResult searchMultiPV(
+        RootMove root_moves[MAX_MOVES],
+        int move_count,
+        int depth,
+        SearchLimits& limits,
+        const SearchResult& previous,
+        int line_count
+    );
+
     // --------------------------- Negamax & Quiescence --------------------------
     int negamax(
         int depth,
         int alpha,
         int beta,
-        PV& pv,
-        std::vector<Move>& previousPV,
         SearchLimits& limits,
-        int ply,
-        bool can_nmp
+        int ply
     );
 
     int quiescence(
         int alpha,
         int beta,
-        PV& pv,
         SearchLimits& limits,
         int ply,
         int depth,
@@ -148,8 +190,7 @@ public:
         const Move& move,
         const Board& board,
         int ply,
-        const Move& ttMove,
-        const std::vector<Move>& previousPV
+        const Move& ttMove
     );
 
     void orderedMoves(
@@ -157,23 +198,22 @@ public:
         size_t count,
         const Board& board,
         int ply,
-        const Move ttMove,
-        const std::vector<Move>& previousPV
+        const Move ttMove
     );
 
     int generateAndOrderMoves(
         Move moves[MAX_MOVES],
         int ply,
-        const Move ttMove,
-        const std::vector<Move>& previousPV
+        const Move ttMove
     );
 
     // ------------------------------- PV / pruning / helpers -------------------------------
-    void updatePV(
-        std::vector<Move>& pv, 
-        const Move& move, 
-        const std::vector<Move>& childPV
-    );
+    inline void updatePV(int ply, Move move, bool with_child) {
+        int n = with_child ? pv_length[ply + 1] : 0;
+        pv_table[ply][0] = move;
+        std::copy_n(pv_table[ply + 1], n, pv_table[ply] + 1);
+        pv_length[ply] = n + 1;
+    }
 
     bool shouldPrune(
         Move& move,
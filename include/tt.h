@@ -26,27 +26,45 @@ enum BoundType : uint8_t {
 // -------------------------------
 // Transposition Table Entry
 // -------------------------------
-// key      16 bit
-// eval     16 bit
+// key      64 bit
+// eval     32 bit (mate scores reach MATE_SCORE, past int16)
 // depth    16 bit
-// age      16 bit
+// age      16 bit (search generation that last wrote or refreshed the entry)
 // flag     2 bit
 // bestMove 16 bit
 struct TTEntry {
     U64 key = 0;           // Zobrist key
-    int16_t eval = 0;      // Stored evaluation (centipawns)
+    int32_t eval = 0;      // Stored evaluation (centipawns, mates as distance from this node)
     int16_t depth = 0;     // iterative_depth recorded
-    uint16_t age = 0;      // Age counter
+    uint16_t age = 0;      // TranspositionTable::generation at the last store
     BoundType flag = EXACT;
     uint16_t bestMove = 0; // Encoded move
 };
 
+// -------------------------------
+// Mate score adjustment
+// -------------------------------
+// search mate scores count plies from the root, the TT keeps them relative to the stored
+// node so a hit reached at another ply still reports the right distance
+inline int scoreToTT(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY)  return score + ply;
+    if (score <= -MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+inline int scoreFromTT(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY)  return score - ply;
+    if (score <= -MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
 // -------------------------------
 // Transposition Table
 // -------------------------------
 class TranspositionTable {
 public:
     TTStats stats;
+    uint16_t generation = 0; // bumped once per search (newSearch), stamped into stored entries
 
     TranspositionTable(size_t mbSize = 512) {
         resize(mbSize);
@@ -97,19 +115,26 @@ public:
                 filledCount++;   
 
             entry->key = key;
-            entry->eval = static_cast<int16_t>(score);
+            entry->eval = scoreToTT(score, ply);
             entry->depth = static_cast<int16_t>(depth);
             entry->flag = flag;
             entry->bestMove = bestMove.Value();
-            entry->age++;
+            entry->age = generation;
 
             //stats.totalStores++;
             #ifdef DEV
                 STATS_TT_STORE(depth+ply, ply);
             #endif
+        } else {
+            entry->age = generation; // kept deeper result, still in use by this search
         }
     }
 
+    // start of a search: entries stored from here on count towards hashfull
+    void newSearch() {
+        ++generation;
+    }
+
     // Clear all entries
     void clear() {
         std::fill(table.begin(), table.end(), TTEntry{});
@@ -122,6 +147,20 @@ public:
         return filledCount;
     }
 
+    // UCI hashfull: permille of a fixed sample at the front of the table written by the
+    // current search (older entries are replaceable, so they do not count as full)
+    int hashfull() const {
+        size_t sample = std::min<size_t>(1000, entriesCount);
+        size_t used = 0;
+        for (size_t i = 0; i < sample; ++i) used += table[i].key != 0 && table[i].age == generation;
+        return sample ? static_cast<int>(used * 1000 / sample) : 0;
+    }
+
+    // read-only slot access (selftest scans the whole table)
+    const TTEntry& slot(size_t i) const {
+        return table[i];
+    }
+
     double fillRatio() const {
         return static_cast<double>(filledCount) / entriesCount;
     }
@@ -1,9 +1,20 @@
+// zobrist.h
+// Zobrist keys shared by every board: the Polyglot Random64 set, so board hashes are
+// Polyglot hashes and book probes work directly on Board::zobrist_hash.
+//
+// Polyglot layout
+//      pieces      Random64[64 * kind + sq], kind = 2 * type + (white ? 1 : 0)
+//      castling    Random64[768 + i], i = K, Q, k, q
+//      en-passant  Random64[772 + file] - only when a pawn can actually capture
+//      side        Random64[780] - xored when white is to move
+
 #ifndef ZOBRIST_H
 #define ZOBRIST_H
 
 #include "helpers.h"
+#include <array>
 
-const U64 Random64[781] = {
+inline constexpr U64 Random64[781] = {
    U64(0x9D39247E33776D41), U64(0x2AF7398005AAA5C7), U64(0x44DB015024623547), U64(0x9C15F73E62A76AE2),
    U64(0x75834465489C0C89), U64(0x3290AC3A203001BF), U64(0x0FBBAD1F61042279), U64(0xE83A908FF2FB60CA),
    U64(0x0D7E765D58755C10), U64(0x1A083822CEAFE02D), U64(0x9605D5F0E25EC3B0), U64(0xD021FF5CD13A2ED5),
@@ -202,4 +213,30 @@ const U64 Random64[781] = {
    U64(0xF8D626AAAF278509),
 };
 
+namespace Zobrist {
+    // [pt12][sq] with the engine's piece index (white 0..5, black 6..11)
+    inline constexpr std::array<std::array<U64, 64>, 12> pieces = [] {
+        std::array<std::array<U64, 64>, 12> keys{};
+        for (int pt12 = 0; pt12 < 12; pt12++) {
+            int kind = 2 * (pt12 % 6) + (pt12 < 6 ? 1 : 0);
+            for (int sq = 0; sq < 64; sq++)
+                keys[static_cast<size_t>(pt12)][static_cast<size_t>(sq)] = Random64[64 * kind + sq];
+        }
+        return keys;
+    }();
+
+    inline constexpr U64 castling[4]  = { Random64[768], Random64[769], Random64[770], Random64[771] };
+    inline constexpr U64 enpassant[8] = { Random64[772], Random64[773], Random64[774], Random64[775],
+                                          Random64[776], Random64[777], Random64[778], Random64[779] };
+    inline constexpr U64 side = Random64[780];
+
+    // combined key for a castling-rights mask (bit 0..3 = KQkq)
+    constexpr U64 castlingKey(int castling_rights) {
+        U64 key = 0;
+        for (int i = 0; i < 4; i++)
+            if (castling_rights & (1 << i)) key ^= castling[i];
+        return key;
+    }
+}
+
 #endif
\ No newline at end of file
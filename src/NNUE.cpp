@@ -1,4 +1,4 @@
-#include <nnue.h>
+#include <NNUE.h>
 #include <fstream>
 #include <iostream>
 #include <algorithm>
@@ -592,7 +592,7 @@ void NNUE::debug_check_features_after_move(const Board& b) {
     ntm_correct = check_active_features_consistency(acc_ntm, nnue_full.acc_ntm, "NTM", false);
 
     if (!stm_correct || !ntm_correct) {
-        b.allGameMoves.back().PrintMove();
+        if (!b.allGameMoves.empty()) b.allGameMoves.back().PrintMove();
         std::cout << "white pieces" << std::endl; print_bitboard(b.colorBitboards[0]); 
         std::cout << "black pieces" << std::endl; print_bitboard(b.colorBitboards[1]); 
         abort();
@@ -2,44 +2,14 @@
 
 #include <PrecomputedMoveData.h>
 
-// static member definitions
-U64 PrecomputedMoveData::blankPawnMoves[64][2] = {};
-U64 PrecomputedMoveData::fullPawnAttacks[64][2] = {};
-U64 PrecomputedMoveData::blankKnightAttacks[64] = {};
-U64 PrecomputedMoveData::blankKingAttacks[64] = {};
-
-SMasks PrecomputedMoveData::blankBishopAttacks[64][2] = {};
-SMasks PrecomputedMoveData::blankRookAttacks[64][2] = {};
-SMasks PrecomputedMoveData::blankQueenAttacks[64][4] = {};
-
-U64 PrecomputedMoveData::passedPawnMasks[64][2] = {};
-U64 PrecomputedMoveData::rayMasks[64][64] = {};
-U64 PrecomputedMoveData::alignMasks[64][64] = {};
-
-int PrecomputedMoveData::distToEdge[64][8] = {};
-int PrecomputedMoveData::kingMoveDistances[64][64] = {};
-
-void PrecomputedMoveData::init() {
-    generateFullPawnMoves();
-    generateFullPawnAttacks();
-    generateBlankKnightAttacks();
-    generateBlankKingAttacks();
-
-    generateBlankBishopAttacks();
-    generateBlankRookAttacks();
-    generateBlankQueenAttacks();
-
-    generatePassedPawnsMasks();
-    generateKingDistances();
-
-    generateDistToEdge();
-    generateAlignMasks();
-    generateRayMasks();
+namespace {
+    constexpr int iabs(int x) { return x < 0 ? -x : x; }
 }
 
-void PrecomputedMoveData::generateFullPawnMoves() {
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::generateFullPawnMoves() {
+    SquareTable<U64, 2> blankPawnMoves{};
     U64 bitboard = 0ULL;
-    bool isin_init_row;
+    bool isin_init_row = false;
 
     for (int side = 0; side < 2; side++) {
         for (int square = a2; square <= h7; square++) {
@@ -53,9 +23,11 @@ void PrecomputedMoveData::generateFullPawnMoves() {
         }
         bitboard = 0ULL;
     }
+    return blankPawnMoves;
 }
 
-void PrecomputedMoveData::generateFullPawnAttacks() {
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::generateFullPawnAttacks() {
+    SquareTable<U64, 2> fullPawnAttacks{};
     U64 bitboard = 0ULL;
     U64 attacks = 0ULL;
 
@@ -83,17 +55,19 @@ void PrecomputedMoveData::generateFullPawnAttacks() {
             attacks = 0ULL;
         }
     }
+    return fullPawnAttacks;
 }
 
-void PrecomputedMoveData::generateBlankKnightAttacks() { // quadrants are counterclockwise
+constexpr std::array<U64, 64> PrecomputedMoveData::generateBlankKnightAttacks() {
+    std::array<U64, 64> blankKnightAttacks{}; // quadrants are counterclockwise
     U64 bitboard = 0ULL;
     int knight_moves[8] = {-17, -15, -10, -6, 6, 10, 15, 17}; 
     // -17,-10 are q3    -15,-6 are q4    6,15 are q2     10,17 are q1 
-    bool is_on_a_file; // no q2/q3
-    bool is_on_b_file;  // limited q2/q3
-    bool is_on_g_file;  // limited q1/q4
-    bool is_on_h_file; // no q1/q4
-    int target_square;
+    bool is_on_a_file = false; // no q2/q3
+    bool is_on_b_file = false;  // limited q2/q3
+    bool is_on_g_file = false;  // limited q1/q4
+    bool is_on_h_file = false; // no q1/q4
+    int target_square = 0;
 
     for (int square = a1; square <= h8; square++) {
         is_on_a_file = (1ULL << square) & Bits::file_masks[0]; 
@@ -123,13 +97,15 @@ void PrecomputedMoveData::generateBlankKnightAttacks() { // quadrants are counte
         blankKnightAttacks[square] = bitboard;
         bitboard = 0ULL;
     }
+    return blankKnightAttacks;
 }
 
-void PrecomputedMoveData::generateBlankKingAttacks() {
+constexpr std::array<U64, 64> PrecomputedMoveData::generateBlankKingAttacks() {
+    std::array<U64, 64> blankKingAttacks{};
     U64 bitboard = 0ULL;
     int king_moves[] = {-9,-8,-7,-1,1,7,8,9}; // if on a-file then only -8/-7/1/8/9, if on h-file then only -1/-8/-9/8/7
-    int target_square;
-    bool is_on_a_file, is_on_h_file;
+    int target_square = 0;
+    bool is_on_a_file = false, is_on_h_file = false;
 
     for (int square = a1; square <= h8; square++) {
         is_on_a_file = (1ULL << square) & Bits::file_masks[0];
@@ -147,14 +123,16 @@ void PrecomputedMoveData::generateBlankKingAttacks() {
         blankKingAttacks[square] = bitboard;
         bitboard = 0ULL;
     }
+    return blankKingAttacks;
 }
 
 
-void PrecomputedMoveData::generateBlankBishopAttacks() {
-    SMasks mask;
-    int file;
-    int rank;
-    int left_bound; int right_bound;
+constexpr PrecomputedMoveData::SquareTable<SMasks, 2> PrecomputedMoveData::generateBlankBishopAttacks() {
+    SquareTable<SMasks, 2> blankBishopAttacks{};
+    SMasks mask{};
+    int file = 0;
+    int rank = 0;
+    int left_bound = 0; int right_bound = 0;
     U64 bitboard = 0ULL;
     
     for (int square = a1; square <= h8; square++) {
@@ -192,12 +170,14 @@ void PrecomputedMoveData::generateBlankBishopAttacks() {
             bitboard = 0ULL;
         }
     }
+    return blankBishopAttacks;
 }
 
-void PrecomputedMoveData::generateBlankRookAttacks() {
-    SMasks mask;
-    int file;
-    int rank;
+constexpr PrecomputedMoveData::SquareTable<SMasks, 2> PrecomputedMoveData::generateBlankRookAttacks() {
+    SquareTable<SMasks, 2> blankRookAttacks{};
+    SMasks mask{};
+    int file = 0;
+    int rank = 0;
     U64 bitboard = 0ULL;
 
     for (int square = a1; square <= h8; square++) {
@@ -230,23 +210,29 @@ void PrecomputedMoveData::generateBlankRookAttacks() {
         }
     }
 
+    return blankRookAttacks;
 }
 
-void PrecomputedMoveData::generateBlankQueenAttacks() {
-    SMasks mask;
+constexpr PrecomputedMoveData::SquareTable<SMasks, 4> PrecomputedMoveData::generateBlankQueenAttacks() {
+    SquareTable<SMasks, 4> blankQueenAttacks{};
+    const SquareTable<SMasks, 2> bishopAttacks = generateBlankBishopAttacks();
+    const SquareTable<SMasks, 2> rookAttacks = generateBlankRookAttacks();
+    SMasks mask{};
     for (int square = a1; square <= h8; square++) {
         for (int direction = 0; direction < 4; direction++) {
             if (direction < 2)
-                mask = blankBishopAttacks[square][direction];
+                mask = bishopAttacks[square][direction];
             else
-                mask = blankRookAttacks[square][direction-2];
+                mask = rookAttacks[square][direction-2];
             blankQueenAttacks[square][direction] = mask;
         }
     }
+    return blankQueenAttacks;
 }
 
 
-void PrecomputedMoveData::generatePassedPawnsMasks() {
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::generatePassedPawnsMasks() {
+    SquareTable<U64, 2> passedPawnMasks{};
     for (int sq = 0; sq < 64; sq++) {
         int file = sq % 8;
         int rank = sq / 8;
@@ -277,11 +263,13 @@ void PrecomputedMoveData::generatePassedPawnsMasks() {
         passedPawnMasks[sq][0] = maskWhite; // For white pawn at sq: enemy pawns here block it
         passedPawnMasks[sq][1] = maskBlack; // For black pawn at sq: enemy pawns here block it
     }
+    return passedPawnMasks;
 }
 
-void PrecomputedMoveData::generateKingDistances() {
-    int file1, file2, rank1, rank2;
-    int rankDistance, fileDistance;
+constexpr PrecomputedMoveData::SquareTable<int, 64> PrecomputedMoveData::generateKingDistances() {
+    SquareTable<int, 64> kingMoveDistances{};
+    int file1 = 0, file2 = 0, rank1 = 0, rank2 = 0;
+    int rankDistance = 0, fileDistance = 0;
 
     for (int sq1 = a1; sq1 <= h8; sq1++) {
         for (int sq2 = a1; sq2 <= h8; sq2++) {
@@ -291,21 +279,23 @@ void PrecomputedMoveData::generateKingDistances() {
             rank1 = sq1 >> 3;
             rank2 = sq2 >> 3;
 
-            rankDistance = abs(rank2 - rank1);
-            fileDistance = abs(file2 - file1);
+            rankDistance = iabs(rank2 - rank1);
+            fileDistance = iabs(file2 - file1);
 
             kingMoveDistances[sq1][sq2] = std::max(rankDistance, fileDistance);
         }
     }
+    return kingMoveDistances;
 }
 
 
 // straight line mask that contains the entire line in the direction of a->b
-void PrecomputedMoveData::generateAlignMasks() {
-    int a_rank, b_rank, a_file, b_file;
-    int rank_dir, file_dir; // {-1,0,1}
-    int target_rank, target_file;
-    int square;
+constexpr PrecomputedMoveData::SquareTable<U64, 64> PrecomputedMoveData::generateAlignMasks() {
+    SquareTable<U64, 64> alignMasks{};
+    int a_rank = 0, b_rank = 0, a_file = 0, b_file = 0;
+    int rank_dir = 0, file_dir = 0; // {-1,0,1}
+    int target_rank = 0, target_file = 0;
+    int square = 0;
 
     for (int a = a1; a <= h8; a++) {
         a_rank = a / 8;
@@ -314,7 +304,7 @@ void PrecomputedMoveData::generateAlignMasks() {
             b_rank = b / 8;
             b_file = b % 8;
 
-            if (abs(b_file - a_file) == abs(b_rank - a_rank) || b_file == a_file || b_rank == a_rank) {
+            if (iabs(b_file - a_file) == iabs(b_rank - a_rank) || b_file == a_file || b_rank == a_rank) {
                 rank_dir = (b_rank > a_rank) ? 1 : (b_rank < a_rank) ? -1 : 0;
                 file_dir = (b_file > a_file) ? 1 : (b_file < a_file) ? -1 : 0;
 
@@ -328,11 +318,13 @@ void PrecomputedMoveData::generateAlignMasks() {
             } 
         }
     }
+    return alignMasks;
 }
 
 // ray that goes from square -> edge in all 8 directions
-void PrecomputedMoveData::generateRayMasks() {
-    int a_rank, a_file, b_rank, b_file, rank_dir, file_dir, target_square, target_rank, target_file;
+constexpr PrecomputedMoveData::SquareTable<U64, 64> PrecomputedMoveData::generateRayMasks() {
+    SquareTable<U64, 64> rayMasks{};
+    int a_rank = 0, a_file = 0, b_rank = 0, b_file = 0, rank_dir = 0, file_dir = 0, target_square = 0, target_rank = 0, target_file = 0;
     for (int a = a1; a <= h8; a++) {
         for (int b = a1; b <= h8; b++) {
             a_rank = a / 8;
@@ -344,7 +336,7 @@ void PrecomputedMoveData::generateRayMasks() {
             file_dir = 0;
 
             // check along array
-            if (abs(b_file - a_file) == abs(b_rank - a_rank) || b_file == a_file || b_rank == a_rank) {
+            if (iabs(b_file - a_file) == iabs(b_rank - a_rank) || b_file == a_file || b_rank == a_rank) {
                 
                 rank_dir = (b_rank > a_rank) ? 1 : (b_rank < a_rank) ? -1 : 0;
                 file_dir = (b_file > a_file) ? 1 : (b_file < a_file) ? -1 : 0;
@@ -369,11 +361,13 @@ void PrecomputedMoveData::generateRayMasks() {
             }
         }
     }
+    return rayMasks;
 }
 
 // direction = N, NE, E, SE, S, SW, W, NW
-void PrecomputedMoveData::generateDistToEdge() {
-    int rank, file;
+constexpr PrecomputedMoveData::SquareTable<int, 8> PrecomputedMoveData::generateDistToEdge() {
+    SquareTable<int, 8> distToEdge{};
+    int rank = 0, file = 0;
 
     for (int square = 0; square < 64; square++) {
         rank = square / 8;
@@ -389,5 +383,23 @@ void PrecomputedMoveData::generateDistToEdge() {
         distToEdge[square][7] = std::min(7-rank,file);
     }
 
+    return distToEdge;
 }
 
+// ---------------- static member definitions ----------------
+// constexpr initializers: evaluated by the compiler, nothing runs at startup
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::blankPawnMoves = generateFullPawnMoves();
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::fullPawnAttacks = generateFullPawnAttacks();
+constexpr std::array<U64, 64> PrecomputedMoveData::blankKnightAttacks = generateBlankKnightAttacks();
+constexpr std::array<U64, 64> PrecomputedMoveData::blankKingAttacks = generateBlankKingAttacks();
+
+constexpr PrecomputedMoveData::SquareTable<SMasks, 2> PrecomputedMoveData::blankBishopAttacks = generateBlankBishopAttacks();
+constexpr PrecomputedMoveData::SquareTable<SMasks, 2> PrecomputedMoveData::blankRookAttacks = generateBlankRookAttacks();
+constexpr PrecomputedMoveData::SquareTable<SMasks, 4> PrecomputedMoveData::blankQueenAttacks = generateBlankQueenAttacks();
+
+constexpr PrecomputedMoveData::SquareTable<U64, 2> PrecomputedMoveData::passedPawnMasks = generatePassedPawnsMasks();
+constexpr PrecomputedMoveData::SquareTable<U64, 64> PrecomputedMoveData::rayMasks = generateRayMasks();
+constexpr PrecomputedMoveData::SquareTable<U64, 64> PrecomputedMoveData::alignMasks = generateAlignMasks();
+
+constexpr PrecomputedMoveData::SquareTable<int, 8> PrecomputedMoveData::distToEdge = generateDistToEdge();
+constexpr PrecomputedMoveData::SquareTable<int, 64> PrecomputedMoveData::kingMoveDistances = generateKingDistances();
@@ -34,6 +34,11 @@ void UCI::handleCommand(const std::string& line) {
 
     Logging::logUCIin(line); // cmd -> engine
 
+    // while a search runs only stop / isready / ponderhit / quit are serviced right away,
+    // anything else waits for it to finish (the search thread sends bestmove)
+    if (token != "stop" && token != "isready" && token != "ponderhit" && token != "quit")
+        engine->waitForSearch();
+
     // standard commands
     if ((token == "uci") || (token == "uci_dev")) {
             std::cout << "id name tomahawk\n";
@@ -45,6 +50,7 @@ void UCI::handleCommand(const std::string& line) {
             std::cout << "option name Threads type spin default " << engine->engine_options.MAX_THREADS<< " min 1 max 1\n";
             std::cout << "option name Hash type spin default " << engine->engine_options.HASH_SIZE_MB<< " min 1 max 1024\n";
             std::cout << "option name Ponder type check default " << engine->engine_options.PONDERING << "\n";
+            std::cout << "option name MultiPV type spin default " << engine->engine_options.MULTI_PV << " min 1 max " << MAX_MULTI_PV << "\n";
             if (token == "uci_dev") {std::cout << std::endl;} // line break
             // Required for lichess
             std::cout << "option name UCI_ShowWDL type check default " << engine->engine_options.UCI_SHOW_WDL << "\n";
@@ -84,7 +90,7 @@ void UCI::handleCommand(const std::string& line) {
             std::cout << "uciok\n";
     }
     else if (token == "isready") {
-        std::cout << "readyok\n";
+        std::cout << "readyok" << std::endl;
     }
     else if (token == "setoption") {
         handleSetOption(iss);
@@ -100,11 +106,11 @@ void UCI::handleCommand(const std::string& line) {
     }
     else if (token == "stop") {
         engine->stopSearch();
-        std::string best = engine->bestMove.uci();
-        std::cout << "bestmove " << best << "\n";
+        engine->waitForSearch();
     }
     else if (token == "quit") {
         engine->stopSearch();
+        engine->waitForSearch();
     }
     else if (token == "config") { // see config options and apply
         fs::path dir = fs::path(PROJECT_ROOT) / "bin/configs";
@@ -167,7 +173,7 @@ void UCI::handleCommand(const std::string& line) {
         engine->create_config_file(name);
     }
     else if (token == "ponderhit") {
-        //
+        engine->ponderHit();
     }
     // custom commands
     else if (token == "static_eval") {
@@ -177,10 +183,28 @@ void UCI::handleCommand(const std::string& line) {
     else if (token == "nnue_eval") {
         engine->nnueEvalTest();
     }
-    else if (token == "perft") {
-        int depth;
-        iss >> depth;
-        engine->perftPrint(depth);
+    else if (token == "perft") { // perft <depth> [threads] [hash_mb]
+        int perft_depth = 0, threads = 0;
+        size_t hash_mb = 64;
+        iss >> perft_depth;
+        if (int t; iss >> t) threads = t;
+        if (size_t mb; iss >> mb) hash_mb = mb;
+        engine->perftPrint(perft_depth, threads, hash_mb);
+    }
+    else if (token == "perftsuite") { // perftsuite [file] [maxdepth] [threads] [hash_mb]
+        fs::path file = fs::path(PROJECT_ROOT) / "bin/test_positions/perft.epd";
+        PerftSuiteSettings suite;
+        std::string arg;
+        // without a file the numbers apply to the default suite
+        if (iss >> arg && !std::all_of(arg.begin(), arg.end(), ::isdigit)) {
+            file = arg;
+            arg.clear();
+            iss >> arg;
+        }
+        if (!arg.empty()) suite.max_depth = std::stoi(arg);
+        if (int t; iss >> t) suite.threads = t;
+        if (size_t mb; iss >> mb) suite.hash_mb = mb;
+        engine->perftSuite(file, suite);
     }
     else if (token == "see") {
         std::string target_sq;
@@ -189,25 +213,32 @@ void UCI::handleCommand(const std::string& line) {
         }
     }
     else if (token == "dumpzobrist") {
+        const Board& gb = engine->game_board;
         std::cout << "\nCurrent Hash: 0x" << std::hex 
-          << engine->game_board.zobrist_hash << "\n";
+          << gb.zobrist_hash << "\n";
         std::cout << "\nLast 10 hashes" << std::endl;
-        for (int i = 0; i < std::min(10,(int)engine->game_board.zobrist_history.size()); i++) {
-            const auto& elem = engine->game_board.zobrist_history[engine->game_board.zobrist_history.size() - 1 - i];
-            std::cout << elem << "\n";
+        for (int i = 0; i < std::min(10, gb.keyDepth()); i++) {
+            std::cout << gb.keyAt(i) << "\n";
         }
-        std::cout << "\n--- Rep Stack ---\n";
-
-        int sum = 0;
-        for (const auto& entry : engine->game_board.hash_history) {
-            uint64_t hash = entry.first;
-            int count = entry.second;
-            std::cout << "Hash: 0x" << std::hex << hash 
-                    << "  Count: " << std::dec << count << "\n";
-            sum += count;
+        std::cout << "\n--- Rep Window ---\n";
+
+        // keys the repetition scan can reach (same side to move, since the last irreversible/null move)
+        int end = std::min({int(gb.currentGameState.fiftyMoveCounter), int(gb.currentGameState.pliesFromNull), gb.keyDepth() - 1});
+        int repeats = 0;
+        for (int i = 2; i <= end; i += 2) {
+            U64 key = gb.keyAt(i);
+            if (key == gb.zobrist_hash) repeats++;
+            std::cout << "Ply -" << std::dec << i << "  Hash: 0x" << std::hex << key
+                      << (key == gb.zobrist_hash ? "  (repeat)" : "") << "\n";
         }
-        std::cout << "--- End of Hash History ---\n";
-        std::cout << "allgamemoves.size: " << engine->game_board.allGameMoves.size() << "\tzobrist_history.sum: " << sum << "\tzobrist_vec.size: " << engine->search_board.zobrist_history.size() << std::endl;
+        std::cout << "--- End of Rep Window ---\n";
+        std::cout << std::dec << "allgamemoves.size: " << gb.allGameMoves.size() << "\tkeys: " << gb.keyDepth()
+                  << "\trepeats: " << repeats << "\tthreefold: " << (gb.isThreefold() ? "yes" : "no") << std::endl;
+    }
+    else if (token == "validate") { // board consistency check on the game board
+        std::string why;
+        if (engine->game_board.validate(&why)) std::cout << "board ok" << std::endl;
+        else std::cout << "board inconsistent: " << why << std::endl;
     }
     else if (token == "dump_tt") {
         #ifdef DEV
@@ -227,8 +258,13 @@ void UCI::handleCommand(const std::string& line) {
         engine->tt.clear();
         std::cout << "Cleared!" << std::endl;
     }
-    else if (token == "bench") {
-        //engine->bench(depth);  // implement bench mode
+    else if (token == "bench") { // bench [depth]
+        int bench_depth = BENCH_DEPTH;
+        if (int d; iss >> d) bench_depth = d;
+        engine->bench(bench_depth);
+    }
+    else if (token == "selftest") {
+        engine->selfTest();
     }
     else if (token == "speedtest") {
         //engine->speedTest(); // implement speed test
@@ -317,10 +353,21 @@ void UCI::handleGo(std::istringstream& iss) {
 
     std::string token;
     int movestogo = 0;
-    int nodes = -1;
+    uint64_t nodes = 0;
+    int mate = 0;
     bool infinite = false;
+    bool ponder = false;
+    std::vector<std::string> searchmoves;
+    bool in_searchmoves = false;
 
     while (iss >> token) {
+        // searchmoves runs until the next keyword
+        if (in_searchmoves && token.size() >= 4 && std::isdigit(static_cast<unsigned char>(token[1]))) {
+            searchmoves.push_back(token);
+            continue;
+        }
+        in_searchmoves = false;
+
         if (token == "eval") {
             sendEval = true;            // mark that we want evaluation only
         }
@@ -333,6 +380,9 @@ void UCI::handleGo(std::istringstream& iss) {
         else if (token == "nodes") iss >> nodes;
         else if (token == "movetime") iss >> movetime;
         else if (token == "infinite") infinite = true;
+        else if (token == "ponder") ponder = true;
+        else if (token == "mate") iss >> mate;
+        else if (token == "searchmoves") in_searchmoves = true;
     }
 
     // Apply settings to engine
@@ -345,10 +395,12 @@ void UCI::handleGo(std::istringstream& iss) {
     engine->settings.nodes = nodes;
     engine->settings.movetime = movetime;
     engine->settings.infinite = infinite;
+    engine->settings.ponder = ponder;
+    engine->settings.mate = mate;
+    engine->settings.searchmoves = std::move(searchmoves);
 
     // Otherwise start a normal search
     engine->trackGame();
-    engine->startSearch();
-    engine->sendBestMove(engine->bestMove, sendEval);
+    engine->startSearchThread(sendEval);
 }
 
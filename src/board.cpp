@@ -16,22 +16,53 @@ Board::Board(std::string _fen) {
     setFromFEN(_fen);
 }
 
-// deep copy
-Board::Board(const Board& other) {
-    memcpy(pieceBitboards, other.pieceBitboards, sizeof(pieceBitboards));
-    memcpy(colorBitboards, other.colorBitboards, sizeof(colorBitboards));
-    memcpy(sqToPiece, other.sqToPiece, sizeof(sqToPiece));
-    currentGameState = other.currentGameState;
-    zobrist_hash = other.zobrist_hash;
-    is_white_move = other.is_white_move;
-    move_color = other.move_color;
-    allGameMoves = other.allGameMoves;       // deep copy
-    hash_history = other.hash_history;       // deep copy
-    zobrist_history = other.zobrist_history; // deep copy
-    gameStateHistory = other.gameStateHistory;
+// full copy: the history stacks copy only their live entries
+Board::Board(const Board& other) : Position(other) {
+    fen = other.fen;
+    allGameMoves = other.allGameMoves;
+    positionHistory = other.positionHistory;
+    keyHistory = other.keyHistory;
+    prefixKeys = other.prefixKeys;
+    prefixCount = other.prefixCount;
+}
+
+Board& Board::operator=(const Board& other) {
+    if (this == &other) return *this;
+    copyState(other);
+    allGameMoves = other.allGameMoves;
+    positionHistory = other.positionHistory;
+    keyHistory = other.keyHistory;
+    prefixKeys = other.prefixKeys;
+    prefixCount = other.prefixCount;
+    return *this;
+}
+
+// search copy: the search only unmakes its own moves, so the game's moves + positions stay behind
+// and its keys are referenced (the game board outlives every search on it)
+void Board::cloneForSearch(const Board& game) {
+    if (game.prefixKeys) { *this = game; return; } // a clone of a clone keeps the original prefix
+
+    copyState(game);
+    allGameMoves.clear();
+    positionHistory.clear();
+    keyHistory.clear();
+    keyHistory.push_back(zobrist_hash);
+    prefixKeys = game.keyHistory.data();
+    prefixCount = game.keyHistory.size() - 1;
+}
+
+void Board::copyState(const Board& other) {
+    static_cast<Position&>(*this) = other;
+    fen = other.fen;
+}
 
-    //auditZobrist(other, "post-copy");
-    //assert(zobrist_hash == computeZobristHash());
+// only reachable past MAX_GAME_PLY plies of one game - the dropped half is far outside any
+// fifty-move window and the game board never unmakes that deep
+void Board::trimHistory() {
+    int k = positionHistory.size() / 2;
+    positionHistory.drop_front(k);
+    keyHistory.drop_front(k);
+    allGameMoves.drop_front(std::min(k, allGameMoves.size()));
 }
 
 
@@ -44,10 +75,12 @@ void Board::MakeMove(Move move) {
     #endif
 
     //currentGameState.was_in_check = is_in_check;
+    if (keyHistory.full()) trimHistory();
+    positionHistory.push_back(*this); // copy-make: UnmakeMove restores this snapshot
 
     int old_castling = currentGameState.castlingRights;
     int oldEp = currentGameState.enPassantFile;
-    if (oldEp > -1) zobrist_hash ^= zobrist_enpassant[oldEp];
+    if (oldEp > -1) zobrist_hash ^= Zobrist::enpassant[oldEp];
 
     int start_square = move.StartSquare();
     int target_square = move.TargetSquare();
@@ -81,16 +114,18 @@ void Board::MakeMove(Move move) {
     if (is_promotion) PromoteToPiece(promotion_piece, target_square);
 
     // Update game state
-    currentGameState.capturedPieceType = captured_piece;
+    currentGameState.capturedPieceType = static_cast<int8_t>(captured_piece);
 
     // --------------- SET NEW EP FILE --------------------
+    // only recorded (and hashed) when an enemy pawn could take it - Polyglot rule,
+    // so identical positions always share one key
     int newEp = -1;
-    if (move_flag == Move::pawnTwoUpFlag)
+    if (move_flag == Move::pawnTwoUpFlag && canEnpassantCapture(start_square & 7, 1 - move_color))
         newEp = start_square & 7;   // file of the pawn
-    currentGameState.enPassantFile = newEp;
+    currentGameState.enPassantFile = static_cast<int8_t>(newEp);
     // --------------- ADD NEW EP HASH --------------------
     if (newEp != -1 ) {
-        zobrist_hash ^= zobrist_enpassant[newEp];
+        zobrist_hash ^= Zobrist::enpassant[newEp];
     }
 
     updateFiftyMoveCounter(moved_piece, captured_piece > -1);
@@ -123,204 +158,99 @@ void Board::MakeMove(Move move) {
         }
     }
 
-    zobrist_hash ^= zobristCastlingHash(old_castling);
-    zobrist_hash ^= zobristCastlingHash(currentGameState.castlingRights);
+    zobrist_hash ^= Zobrist::castlingKey(old_castling);
+    zobrist_hash ^= Zobrist::castlingKey(currentGameState.castlingRights);
 
-    if ((pieceBitboards[king] & colorBitboards[0]) == 0 || (pieceBitboards[king] & colorBitboards[1]) == 0) {
-        std::cerr << "\n\nKING MISSING after unmake: ";
-        move.PrintMove();
-        std::cerr << "captured_piece: " << captured_piece << " move_color=" << move_color << "\n\n";
-        print_board(); 
-        std::cerr << "\nmoves: " << allGameMoves.size() << "\n\n" << std::endl;
-        for (int i = allGameMoves.size() - 1; i >= 0; i--) {
-            allGameMoves[i].PrintMove();
-        }
-        assert(false);
-    }
-
-    is_in_check = inCheck(false);
     plyCount++;
     allGameMoves.push_back(move);
 
-    zobrist_hash ^= zobrist_side_to_move;
+    zobrist_hash ^= Zobrist::side;
     is_white_move = !is_white_move;
-    move_color = 1 - move_color;
+    move_color ^= 1;
+    updateCheckInfo();
 
-    hash_history[zobrist_hash]++;
-    zobrist_history.push_back(zobrist_hash);
-    gameStateHistory.push_back(currentGameState);
+    // saturating: a scan further back than 255 plies is already past the fifty-move rule
+    if (currentGameState.pliesFromNull < UINT8_MAX) currentGameState.pliesFromNull++;
+    keyHistory.push_back(zobrist_hash);
+
+    #ifdef DEBUG
+        checkConsistency("MakeMove");
+    #endif
 }
 
 void Board::UnmakeMove(Move move) {
     #ifdef DEV
         ScopedTimer timer(T_UNMAKE_MOVE);
     #endif
+    (void)move; // the snapshot already knows what was moved
 
-    auto it = hash_history.find(zobrist_hash);
-    if (it != hash_history.end()) {
-        it->second--;
-        if (it->second <= 0)
-            hash_history.erase(it);
-        zobrist_history.pop_back();
-    } //else {
-        // Optional: error check
-        //std::cerr << "UnmakeMove: hash not found in history!\n";
-        // Maybe abort or handle gracefully
-    //}
-
-    //if (hash_history[zobrist_hash] < 0) {std::cout << "tf" << std::endl; exit(0);}
-
-    int new_castling = currentGameState.castlingRights;
-
-    // Side to move
-    zobrist_hash ^= zobrist_side_to_move;
-    is_white_move = !is_white_move;
-    move_color = 1 - move_color;
-
-    int moved_from = move.StartSquare();
-    int moved_to = move.TargetSquare();
-    int move_flag = move.MoveFlag();
-    int moved_piece = (move.IsPromotion() || move_flag == Move::enPassantCaptureFlag || move_flag == Move::pawnTwoUpFlag)
-                      ? pawn : getMovedPiece(moved_to);
-    int captured_piece = currentGameState.capturedPieceType;
-    int promotion_piece = move.PromotionPieceType();
-
-    // restore pawn_endgame flag for NMP
-    if (pawn_endgame && (captured_piece > pawn && captured_piece < king)) {
-        pawn_endgame = false;
-    }
-
-    // --- Remove old EP hash (set by move being undone) ---
-    if (currentGameState.enPassantFile != -1) // note: opposite side
-    {
-        zobrist_hash ^= zobrist_enpassant[currentGameState.enPassantFile];
-    }
-
-    // --- Move piece back ---
-    MovePiece(moved_piece, moved_to, moved_from);
-
-    // --- Undo promotion ---
-    if (move.IsPromotion()) {
-        pop_bit(pieceBitboards[promotion_piece], moved_to);
-        zobrist_hash ^= zobrist_table[move_color*6 + promotion_piece][moved_to];
-        zobrist_hash ^= zobrist_table[move_color*6 + pawn][moved_to]; // movePiece() resets so it must be undone
-    }
-
-    // --- Restore captured piece ---
-    if (move_flag == Move::enPassantCaptureFlag) {
-        int ep_square = moved_to + ((move_color == 0) ? -8 : 8);
-        set_bit(pieceBitboards[pawn], ep_square);
-        set_bit(colorBitboards[1 - move_color], ep_square);
-        putPiece(pawn + (1 - move_color) * 6, ep_square);
-        zobrist_hash ^= zobrist_table[(1-move_color)*6+ pawn][ep_square];
-    } else if (captured_piece > -1) {
-        set_bit(pieceBitboards[captured_piece], moved_to);
-        set_bit(colorBitboards[1 - move_color], moved_to);
-        putPiece(captured_piece + (1 - move_color) * 6, moved_to);
-        zobrist_hash ^= zobrist_table[(1-move_color)*6 + captured_piece][moved_to];
-    }
-
-    // --- Undo castling rook moves ---
-    if (move_flag == Move::castleFlag) {
-        if (moved_to == g1) MovePiece(rook, f1, h1), white_castled = false;
-        else if (moved_to == c1) MovePiece(rook, d1, a1), white_castled = false;
-        else if (moved_to == g8) MovePiece(rook, f8, h8), black_castled = false;
-        else if (moved_to == c8) MovePiece(rook, d8, a8), black_castled = false;
-    }
-
-    // --- Restore previous game state ---
-    is_in_check = inCheck(true);
-    gameStateHistory.pop_back();
-    currentGameState = gameStateHistory.back();
-    //is_in_check = currentGameState.was_in_check;
-    
-
-    // --- Castling hash ---
-    zobrist_hash ^= zobristCastlingHash(new_castling);
-    zobrist_hash ^= zobristCastlingHash(currentGameState.castlingRights);
-
-    // --- Restore EP hash (the EP square before the move) ---
-    if (currentGameState.enPassantFile != -1)
-    {
-        zobrist_hash ^= zobrist_enpassant[currentGameState.enPassantFile];
-    }
-
-    // --- Finish ---
-    plyCount--;
+    static_cast<Position&>(*this) = positionHistory.back();
+    positionHistory.pop_back();
+    keyHistory.pop_back();
     allGameMoves.pop_back();
+
+    #ifdef DEBUG
+        checkConsistency("UnmakeMove");
+    #endif
 }
 
 // -----------------------------------
 // Null Moves
 // -----------------------------------
 
-// minimal implementations of moves
-// no hash updates, move history, or game state updates since these are not needed 
-// for null move pruning and would be expensive to maintain
+// minimal implementations of moves: flip side, drop the ep square
+// (snapshot + key + NullMove marker, so unmake is the same restore as a real move)
 void Board::MakeNullMove() {
     //ScopedTimer timer(T_MAKENULLMOVE);
+    if (keyHistory.full()) trimHistory();
+    positionHistory.push_back(*this);
 
     // clear EP + captured_piece
     currentGameState.capturedPieceType = -1;
     if (currentGameState.enPassantFile != -1) {
-        zobrist_hash ^= zobrist_enpassant[currentGameState.enPassantFile];
+        zobrist_hash ^= Zobrist::enpassant[currentGameState.enPassantFile];
         currentGameState.enPassantFile = -1;
     }
 
     // flipp side to move
-    zobrist_hash ^= zobrist_side_to_move;
+    zobrist_hash ^= Zobrist::side;
     is_white_move = !is_white_move;
-    move_color = 1 - move_color;
+    move_color ^= 1;
 
     // track history for NMP-tree TT
     // wont plague regular TT since STM is flipped so hash's will never match
-    gameStateHistory.push_back(currentGameState);
-    hash_history[zobrist_hash]++;
-    zobrist_history.push_back(zobrist_hash);
+    // repetition scans must not cross the null move
+    currentGameState.pliesFromNull = 0;
+    keyHistory.push_back(zobrist_hash);
     allGameMoves.push_back(Move::NullMove());
-    //gameStateHistory.push_back(currentGameState);
 
+    // pieces did not move: blockers still hold, and the side that passed was not in check
+    currentGameState.checkers = 0ULL;
     is_in_check = false;
     plyCount++;
+
+    #ifdef DEBUG
+        checkConsistency("MakeNullMove");
+    #endif
 }
 
 void Board::UnmakeNullMove() {
     //ScopedTimer timer(T_UNMAKENULLMOVE);
-
-    // undo hash history
-    auto it = hash_history.find(zobrist_hash);
-    if (it != hash_history.end()) {
-        it->second--;
-       if (it->second <= 0)
-            hash_history.erase(it);
-    }
-    zobrist_history.pop_back();
-
-    // flip STM back
-    zobrist_hash ^= zobrist_side_to_move;
-    is_white_move = !is_white_move;
-    move_color = 1 - move_color;
-
-    // restore gamestate and re-add EP hash if the original state had one
+    static_cast<Position&>(*this) = positionHistory.back();
+    positionHistory.pop_back();
+    keyHistory.pop_back();
     allGameMoves.pop_back();
-    gameStateHistory.pop_back(); // post-null-move gameState
-    currentGameState = gameStateHistory.back(); // gameState after last real move
-    if (currentGameState.enPassantFile != -1)
-        zobrist_hash ^= zobrist_enpassant[currentGameState.enPassantFile];
 
-    is_in_check = false;
-    plyCount--;
+    #ifdef DEBUG
+        checkConsistency("UnmakeNullMove");
+    #endif
 }
 
 // ------------------------------------------------------------
 // Bitboard manipulation helpers
 // ------------------------------------------------------------
-void Board::putPiece(int pt12, int sq) { sqToPiece[sq] = pt12; }
-void Board::removePiece(int sq) {
-    int pt12 = sqToPiece[sq];
-    if (pt12 == -1) return;
-    sqToPiece[sq] = -1;
-}
+void Board::putPiece(int pt12, int sq) { sqToPiece[sq] = static_cast<int8_t>(pt12); }
+void Board::removePiece(int sq) { sqToPiece[sq] = -1; }
 
 void Board::MovePiece(int piece, int start_square, int target_square) {
     if (piece == -1) return;
@@ -332,10 +262,12 @@ void Board::MovePiece(int piece, int start_square, int target_square) {
 
     removePiece(start_square);
     putPiece(piece + (is_white_move ? 0 : 6), target_square);
+    if (piece == king) currentGameState.kingSquare[move_color] = static_cast<int8_t>(target_square);
+    if (piece == pawn) pawnKey ^= Zobrist::pieces[move_color*6 + pawn][start_square] ^ Zobrist::pieces[move_color*6 + pawn][target_square];
 
     // b-p =0, w-p =1, b-n=2, w-n=3, etc..
-    zobrist_hash ^= zobrist_table[move_color*6 + piece][start_square]; //[move_color*6 + piece][start_square];
-    zobrist_hash ^= zobrist_table[move_color*6 + piece][target_square];
+    zobrist_hash ^= Zobrist::pieces[move_color*6 + piece][start_square]; //[move_color*6 + piece][start_square];
+    zobrist_hash ^= Zobrist::pieces[move_color*6 + piece][target_square];
 }
 
 void Board::CapturePiece(int piece, int target_square, bool is_enpassant, bool captured_is_moved_piece) {
@@ -344,49 +276,44 @@ void Board::CapturePiece(int piece, int target_square, bool is_enpassant, bool c
 
         pop_bit(pieceBitboards[piece], cap_sq);
         pop_bit(colorBitboards[1-move_color], cap_sq);
-        zobrist_hash ^= zobrist_table[(1-move_color)*6 + piece][int(cap_sq)];
+        removePiece(cap_sq);
+        zobrist_hash ^= Zobrist::pieces[(1-move_color)*6 + piece][int(cap_sq)];
+        pawnKey ^= Zobrist::pieces[(1-move_color)*6 + pawn][cap_sq];
     } else if (captured_is_moved_piece) {
         pop_bit(colorBitboards[1-move_color], target_square);
-        zobrist_hash ^= zobrist_table[(1-move_color)*6 + piece][target_square];
+        zobrist_hash ^= Zobrist::pieces[(1-move_color)*6 + piece][target_square];
     } else {
         pop_bit(pieceBitboards[piece], target_square);
         pop_bit(colorBitboards[1-move_color], target_square);
-        zobrist_hash ^= zobrist_table[(1-move_color)*6 + piece][target_square];
+        zobrist_hash ^= Zobrist::pieces[(1-move_color)*6 + piece][target_square];
     }
 
-    if (
-        !pawn_endgame
-        && !(pieceBitboards[knight]
-                | pieceBitboards[bishop]
-                | pieceBitboards[rook]
-                | pieceBitboards[queen])
-    ) {
-        pawn_endgame = true;
-    }
+    materialKey -= materialUnit((1-move_color)*6 + piece);
+    if (piece == pawn && !is_enpassant) pawnKey ^= Zobrist::pieces[(1-move_color)*6 + pawn][target_square];
 }
 
 void Board::PromoteToPiece(int piece, int target_square) {
     pop_bit(pieceBitboards[pawn], target_square);
     set_bit(pieceBitboards[piece], target_square);
-    zobrist_hash ^= zobrist_table[move_color*6 + piece][target_square];
-    zobrist_hash ^= zobrist_table[move_color*6 + pawn][target_square];
+    putPiece(piece + move_color * 6, target_square);
+    materialKey += materialUnit(move_color*6 + piece) - materialUnit(move_color*6 + pawn);
+    pawnKey ^= Zobrist::pieces[move_color*6 + pawn][target_square];
+    zobrist_hash ^= Zobrist::pieces[move_color*6 + piece][target_square];
+    zobrist_hash ^= Zobrist::pieces[move_color*6 + pawn][target_square];
 }
 
 // ------------------------------------------------------------
 // Piece / square queries
 // ------------------------------------------------------------
+// mailbox lookups (0..5, -1 if empty) - validate() keeps sqToPiece honest against the bitboards
 int Board::getMovedPiece(int start_square) const {
-    for (int piece=0; piece<6; piece++)
-        if (get_bit(pieceBitboards[piece], start_square))
-            return piece;
-    return -1;
+    int pt12 = sqToPiece[start_square];
+    return pt12 < 0 ? -1 : pt12 % 6;
 }
 
 int Board::getCapturedPiece(int target_square) const {
-    for (int piece=0; piece<6; piece++)
-        if (get_bit(pieceBitboards[piece], target_square))
-            return piece;
-    return -1;
+    int pt12 = sqToPiece[target_square];
+    return pt12 < 0 ? -1 : pt12 % 6;
 }
 
 int Board::getSideAt(int square) const {
@@ -404,24 +331,15 @@ int Board::getPieceAt(int square, int side) const {
 }
 
 int Board::kingSquare(bool white) const {
-    U64 kings = pieceBitboards[king];
-    U64 side = white ? colorBitboards[0] : colorBitboards[1];
-    return sqidx(kings & side);
+    return currentGameState.kingSquare[white ? 0 : 1];
 }
 
-bool Board::canEnpassantCapture(int epFile) const {
+bool Board::canEnpassantCapture(int epFile, int side) const {
     if (epFile < 0 || epFile > 7) return false;
 
-    U64 epMask = 0ULL;
-    if (is_white_move) {
-        if (epFile>0) epMask |= (1ULL << (32+epFile-1));
-        if (epFile<7) epMask |= (1ULL << (32+epFile+1));
-        return (pieceBitboards[1] & colorBitboards[0] & epMask) != 0;
-    } else {
-        if (epFile>0) epMask |= (1ULL << (24+epFile-1));
-        if (epFile<7) epMask |= (1ULL << (24+epFile+1));
-        return (pieceBitboards[1] & colorBitboards[1] & epMask) != 0;
-    }
+    // side's pawns that attack the ep square (= squares an opposing pawn on it would attack)
+    int ep_square = (side == white ? 40 : 16) + epFile;
+    return (pieceBitboards[pawn] & colorBitboards[side] & PrecomputedMoveData::fullPawnAttacks[ep_square][1 - side]) != 0;
 }
 
 void Board::updateFiftyMoveCounter(int moved_piece, bool isCapture) {
@@ -435,20 +353,32 @@ void Board::updateFiftyMoveCounter(int moved_piece, bool isCapture) {
 
 }
 
-bool Board::isThreefold() {
+// repetitions can only be against the same side to move (every other ply),
+// and never across an irreversible move (fifty counter) or a null move
+bool Board::isThreefold() const {
+    int end = std::min({int(currentGameState.fiftyMoveCounter), int(currentGameState.pliesFromNull), keyDepth() - 1});
     int count = 0;
 
-    // Number of positions to look back: since last irreversible move
-    int lookback = std::min<int>(currentGameState.fiftyMoveCounter + 1, zobrist_history.size());
-
-    // Iterate backwards over just those positions
-    for (int i = static_cast<int>(zobrist_history.size()) - lookback; i < static_cast<int>(zobrist_history.size()); ++i) {
-        if (zobrist_history[i] == zobrist_hash)
-            count++;
-        if (count >= 3)
+    for (int i = 4; i <= end; i += 2) {
+        if (keyAt(i) == zobrist_hash && ++count == 2)
             return true;
     }
+    return false;
+}
 
+// ply = distance to the search root
+// a position repeated inside the search tree is scored as a draw on its first repeat (the side
+// that can repeat once can repeat again); repeats of pre-root history still need the full threefold
+bool Board::isRepetition(int ply) const {
+    int end = std::min({int(currentGameState.fiftyMoveCounter), int(currentGameState.pliesFromNull), keyDepth() - 1});
+    int count = 0;
+
+    for (int i = 4; i <= end; i += 2) {
+        if (keyAt(i) == zobrist_hash) {
+            if (i < ply) return true;
+            if (++count == 2) return true;
+        }
+    }
     return false;
 }
 
@@ -485,14 +415,61 @@ bool Board::inCheck(bool init) {
     return false;
 }
 
+namespace {
+    // castling right bit i (K, Q, k, q) needs this king and rook on their home squares
+    constexpr int CASTLE_KING_SQ[4] = { e1, e1, e8, e8 };
+    constexpr int CASTLE_ROOK_SQ[4] = { h1, a1, h8, a8 };
+
+    bool castlingPiecesHome(const Position& pos, int i) {
+        int c = i / 2;
+        return pos.sqToPiece[CASTLE_KING_SQ[i]] == king + c * 6 && pos.sqToPiece[CASTLE_ROOK_SQ[i]] == rook + c * 6;
+    }
+
+    // checkers of the side to move, and for both kings the lone pieces between it and an enemy
+    // slider (blockers) - shared by the make path and validate()
+    void computeCheckInfo(const Position& pos, GameState& st) {
+        const U64 occ = pos.colorBitboards[0] | pos.colorBitboards[1];
+        const U64 diag = pos.pieceBitboards[bishop] | pos.pieceBitboards[queen];
+        const U64 ortho = pos.pieceBitboards[rook] | pos.pieceBitboards[queen];
+
+        for (int c = 0; c < 2; c++) {
+            int ksq = st.kingSquare[c];
+            U64 blockers = 0ULL;
+
+            // enemy sliders that would see the king on an empty board
+            U64 snipers = ((Magics::rookAttacks(ksq, 0ULL) & ortho) | (Magics::bishopAttacks(ksq, 0ULL) & diag)) & pos.colorBitboards[1 - c];
+            while (snipers) {
+                int sniper_sq = getLSB(snipers);
+                snipers &= snipers - 1;
+
+                U64 b = PrecomputedMoveData::between(ksq, sniper_sq) & occ;
+                if (b && !(b & (b - 1))) blockers |= b;
+            }
+            st.blockersForKing[c] = blockers;
+        }
+
+        const int us = pos.move_color;
+        const int ksq = st.kingSquare[us];
+        st.checkers = ((PrecomputedMoveData::fullPawnAttacks[ksq][us] & pos.pieceBitboards[pawn])
+                     | (PrecomputedMoveData::blankKnightAttacks[ksq] & pos.pieceBitboards[knight])
+                     | (Magics::bishopAttacks(ksq, occ) & diag)
+                     | (Magics::rookAttacks(ksq, occ) & ortho)) & pos.colorBitboards[1 - us];
+    }
+}
+
+// once per make, restored by unmake with the snapshot
+void Board::updateCheckInfo() {
+    computeCheckInfo(*this, currentGameState);
+    is_in_check = currentGameState.checkers != 0;
+}
+
 // ------------------------------------------------------------
 // FEN handling
 // ------------------------------------------------------------
 std::string Board::getBoardFEN() { setBoardFEN(); return fen; }
 
 void Board::setFromFEN(std::string _fen) {
-    hash_history.clear();
-    zobrist_history.clear();
+    resetHistory();
 
     std::istringstream fenStream(_fen);
     std::string boardState, turn, castling_rights, ep;
@@ -503,7 +480,6 @@ void Board::setFromFEN(std::string _fen) {
  
     // Reset state
     currentGameState = GameState();
-    allGameMoves.clear();
     for (int i=0;i<6;i++) pieceBitboards[i]=0ULL;
     for (int i=0;i<2;i++) colorBitboards[i]=0ULL;
     std::fill(std::begin(sqToPiece), std::end(sqToPiece), -1);
@@ -517,7 +493,6 @@ void Board::setFromFEN(std::string _fen) {
             pieceBitboards[piece] |= (1ULL << (row*8+col));
             if (islower(square)) { colorBitboards[1] |= (1ULL << (row*8+col)); putPiece(piece+6,row*8+col);}
             else { colorBitboards[0] |= (1ULL << (row*8+col)); putPiece(piece,row*8+col);}
-            sqToPiece[row*8+col] = piece + (islower(square) ? 6 : 0);
             col++;
         }
     }
@@ -530,18 +505,112 @@ void Board::setFromFEN(std::string _fen) {
         if (castling_rights.find("k")!=std::string::npos) currentGameState.castlingRights |= 0x4;
         if (castling_rights.find("q")!=std::string::npos) currentGameState.castlingRights |= 0x8;
     }
-    currentGameState.enPassantFile = (ep=="-") ? -1 : static_cast<int>(file_char.find(ep.substr(0,1)));
-    currentGameState.fiftyMoveCounter = fifty_move;
-    plyCount = is_white_move ? (full_moves-1)*2 : (full_moves-1)*2+1;
+    currentGameState.enPassantFile = static_cast<int8_t>((ep=="-") ? -1 : static_cast<int>(file_char.find(ep.substr(0,1))));
+    currentGameState.fiftyMoveCounter = static_cast<int16_t>(fifty_move);
+    plyCount = static_cast<int16_t>(is_white_move ? (full_moves-1)*2 : (full_moves-1)*2+1);
+
+    finishSetup();
+}
 
+void Board::resetHistory() {
+    allGameMoves.clear();
+    positionHistory.clear();
+    keyHistory.clear();
+    prefixKeys = nullptr;
+    prefixCount = 0;
+}
+
+// pieces, side to move and game state are set - derive the rest
+void Board::finishSetup() {
     move_color = is_white_move ? 0 : 1;
-    is_in_check = inCheck(true);
-    gameStateHistory.push_back(currentGameState);
+    white_castled = black_castled = false;
+    if (!canEnpassantCapture(currentGameState.enPassantFile, move_color))
+        currentGameState.enPassantFile = -1; // same rule as MakeMove
+    for (int i = 0; i < 4; i++) {
+        // a FEN or packed record can claim a right its king / rook no longer backs up
+        if (!castlingPiecesHome(*this, i)) currentGameState.castlingRights &= static_cast<int8_t>(~(1 << i));
+    }
+    for (int c = 0; c < 2; c++)
+        currentGameState.kingSquare[c] = static_cast<int8_t>(sqidx(pieceBitboards[king] & colorBitboards[c]));
+    updateCheckInfo();
 
-    initZobristKeys();
     zobrist_hash = computeZobristHash();
-    hash_history[zobrist_hash]++;
-    zobrist_history.push_back(zobrist_hash);
+    materialKey = computeMaterialKey();
+    pawnKey = computePawnKey();
+    keyHistory.push_back(zobrist_hash);
+}
+
+// ------------------------------------------------------------
+// Packed encoding
+// ------------------------------------------------------------
+PackedPosition Board::pack() const {
+    PackedPosition packed;
+    uint8_t* out = packed.bytes;
+
+    const U64 occ = colorBitboards[0] | colorBitboards[1];
+    for (int i = 0; i < 8; i++) out[i] = static_cast<uint8_t>(occ >> (8 * i));
+
+    // up to 32 pieces, nibble i belongs to the i-th occupied square
+    U64 bb = occ;
+    for (int i = 0; bb && i < 32; i++) {
+        int sq = getLSB(bb);
+        bb &= bb - 1;
+        out[8 + i / 2] |= static_cast<uint8_t>(sqToPiece[sq] << (4 * (i & 1)));
+    }
+
+    out[24] = static_cast<uint8_t>(move_color | (currentGameState.castlingRights << 1));
+    out[25] = static_cast<uint8_t>(currentGameState.enPassantFile + 1);
+    out[26] = static_cast<uint8_t>(std::min<int>(currentGameState.fiftyMoveCounter, 255));
+    out[28] = static_cast<uint8_t>(plyCount & 0xFF);
+    out[29] = static_cast<uint8_t>((plyCount >> 8) & 0xFF);
+    return packed;
+}
+
+bool Board::unpack(const PackedPosition& packed) {
+    const uint8_t* in = packed.bytes;
+
+    U64 occ = 0ULL;
+    for (int i = 0; i < 8; i++) occ |= static_cast<U64>(in[i]) << (8 * i);
+    if (countBits(occ) > 32 || in[25] > 8 || (in[24] >> 5)) return false;
+
+    // check the record before touching the board
+    int kings[2] = {0, 0};
+    U64 bb = occ;
+    for (int i = 0; bb; i++) {
+        int sq = getLSB(bb);
+        bb &= bb - 1;
+        int pt12 = (in[8 + i / 2] >> (4 * (i & 1))) & 0xF;
+        if (pt12 > 11) return false;
+        if (pt12 % 6 == pawn && (sq < 8 || sq > 55)) return false;
+        if (pt12 % 6 == king) kings[pt12 / 6]++;
+    }
+    if (kings[0] != 1 || kings[1] != 1) return false;
+
+    resetHistory();
+    fen.clear();
+    currentGameState = GameState();
+    for (int i = 0; i < 6; i++) pieceBitboards[i] = 0ULL;
+    colorBitboards[0] = colorBitboards[1] = 0ULL;
+    std::fill(std::begin(sqToPiece), std::end(sqToPiece), -1);
+
+    bb = occ;
+    for (int i = 0; bb; i++) {
+        int sq = getLSB(bb);
+        bb &= bb - 1;
+        int pt12 = (in[8 + i / 2] >> (4 * (i & 1))) & 0xF;
+        set_bit(pieceBitboards[pt12 % 6], sq);
+        set_bit(colorBitboards[pt12 / 6], sq);
+        putPiece(pt12, sq);
+    }
+
+    is_white_move = !(in[24] & 1);
+    currentGameState.castlingRights = static_cast<int8_t>((in[24] >> 1) & 0xF);
+    currentGameState.enPassantFile = static_cast<int8_t>(in[25] - 1);
+    currentGameState.fiftyMoveCounter = in[26];
+    plyCount = static_cast<int16_t>(in[28] | (in[29] << 8));
+
+    finishSetup();
+    return true;
 }
 
 void Board::setBoardFEN() {
@@ -618,96 +687,161 @@ void Board::print_board() {
     std::cout << "\nMove: " << plyCount/2 << "\n";
     std::cout << (is_white_move?"White to move":"Black to move") << "\n";
     std::cout << (is_in_check?"Check":"") << "\n";
-    std::cout << "Castling Rights: " << currentGameState.castlingRights << "\n";
-    std::cout << "50 Move Counter: " << currentGameState.fiftyMoveCounter << "\n";
-    std::cout << "En Passant: " << currentGameState.enPassantFile << "\n";
-    std::cout << "Captured Piece: " << currentGameState.capturedPieceType << "\n\n";
+    std::cout << "Castling Rights: " << int(currentGameState.castlingRights) << "\n";
+    std::cout << "50 Move Counter: " << int(currentGameState.fiftyMoveCounter) << "\n";
+    std::cout << "En Passant: " << int(currentGameState.enPassantFile) << "\n";
+    std::cout << "Captured Piece: " << int(currentGameState.capturedPieceType) << "\n\n";
 }
 
 // ------------------------------------------------------------
-// Zobrist hashing functions
+// Consistency checks
 // ------------------------------------------------------------
 
-U64 Board::randomU64() {
-    static std::mt19937_64 rng(42); // static - persistent
-    return rng();
-}
+// recomputes everything make/unmake maintain incrementally and compares:
+// bitboards vs each other, mailbox vs bitboards, kings, hash, ep file, castling rights, check info
+bool Board::validate(std::string* error) const {
+    auto fail = [&](const std::string& why) {
+        if (error) *error = why;
+        return false;
+    };
 
-/*
-void Board::initPolyglotKeys() {
-    std::mt19937_64 rng(42); 
-    
-    for (int piece = 0; piece < 12; ++piece)
-        for (int square = 0; square < 64; ++square)
-            polyglot_table[piece][square] = Random64[piece*64 + square];
+    const U64 occ = colorBitboards[0] | colorBitboards[1];
+    if (colorBitboards[0] & colorBitboards[1]) return fail("color bitboards overlap");
 
-    for (int i = 0; i < 4; ++i)
-        polyglot_castling[i] = Random64[768 + i];
+    U64 pieces = 0ULL;
+    for (int piece = 0; piece < 6; piece++) {
+        if (pieces & pieceBitboards[piece]) return fail("piece bitboard " + std::to_string(piece) + " overlaps another");
+        pieces |= pieceBitboards[piece];
+    }
+    if (pieces != occ) return fail("piece bitboards do not cover the color bitboards");
+    if (pieceBitboards[pawn] & 0xFF000000000000FFULL) return fail("pawn on the first or last rank");
+
+    for (int sq = 0; sq < 64; sq++) {
+        int expected = -1;
+        if (get_bit(occ, sq)) {
+            int piece = 0;
+            while (!get_bit(pieceBitboards[piece], sq)) piece++;
+            expected = piece + (get_bit(colorBitboards[1], sq) ? 6 : 0);
+        }
+        if (sqToPiece[sq] != expected)
+            return fail("sqToPiece[" + std::to_string(sq) + "] = " + std::to_string(sqToPiece[sq])
+                        + ", bitboards say " + std::to_string(expected));
+    }
 
-    for (int i = 0; i < 8; ++i)
-        polyglot_enpassant[i] = Random64[772 + i];
+    for (int c = 0; c < 2; c++) {
+        U64 kings = pieceBitboards[king] & colorBitboards[c];
+        if (!kings || (kings & (kings - 1))) return fail(std::string(c ? "black" : "white") + " does not have exactly one king");
+        if (getLSB(kings) != currentGameState.kingSquare[c]) return fail(std::string(c ? "black" : "white") + " king square cache is stale");
+    }
+
+    if (is_white_move != (move_color == 0)) return fail("is_white_move and move_color disagree");
+
+    if (zobrist_hash != computeZobristHash()) return fail("zobrist_hash does not match a recompute");
+    if (materialKey != computeMaterialKey()) return fail("materialKey does not match the piece counts");
+    if (pawnKey != computePawnKey()) return fail("pawnKey does not match a recompute");
+    if (!keyHistory.empty() && keyHistory.back() != zobrist_hash) return fail("keyHistory.back() is not the current key");
+
+    int ep = currentGameState.enPassantFile;
+    if (ep != -1) {
+        // the pawn that just double-pushed belongs to the side not to move
+        int pushed_sq = move_color == 0 ? 32 + ep : 24 + ep;
+        if (ep < 0 || ep > 7 || sqToPiece[pushed_sq] != pawn + (move_color == 0 ? 6 : 0))
+            return fail("en-passant file without a double-pushed pawn");
+        if (!canEnpassantCapture(ep, move_color)) return fail("en-passant file set but no pawn can capture");
+    }
 
-    polyglot_side_to_move = Random64[780];
+    for (int i = 0; i < 4; i++) {
+        if ((currentGameState.castlingRights & (1 << i)) && !castlingPiecesHome(*this, i))
+            return fail("castling right " + std::to_string(i) + " without king and rook at home");
+    }
+
+    GameState fresh = currentGameState;
+    computeCheckInfo(*this, fresh);
+    if (fresh.checkers != currentGameState.checkers || is_in_check != (fresh.checkers != 0))
+        return fail("checkers / is_in_check are stale");
+    for (int c = 0; c < 2; c++) {
+        if (fresh.blockersForKing[c] != currentGameState.blockersForKing[c])
+            return fail("blockersForKing is stale");
+    }
+
+    return true;
 }
-*/
 
-void Board::initZobristKeys() {
-    std::mt19937_64 rng(42); 
+// checked builds (DEBUG) call this after every make/unmake: report the first broken invariant and stop
+void Board::checkConsistency(const char* where) {
+    std::string why;
+    if (validate(&why)) return;
 
-    for (int piece = 0; piece < 12; ++piece)
-        for (int square = 0; square < 64; ++square)
-            zobrist_table[piece][square] = rng();
+    std::cerr << "\n\nBOARD INCONSISTENT after " << where << ": " << why << "\n";
+    print_board();
+    std::cerr << "\nmoves: " << allGameMoves.size() << "\n\n" << std::endl;
+    for (int i = allGameMoves.size() - 1; i >= 0; i--) {
+        allGameMoves[i].PrintMove();
+    }
+    assert(false);
+}
 
-    for (int i = 0; i < 4; ++i)
-        zobrist_castling[i] = rng();
+// ------------------------------------------------------------
+// Zobrist hashing functions
+// ------------------------------------------------------------
 
-    for (int i = 0; i < 8; ++i)
-        zobrist_enpassant[i] = rng();
+// pawn-only key: the piece part of the full hash restricted to pawns
+U64 Board::computePawnKey() const {
+    U64 key = 0;
+    for (int color = 0; color < 2; color++) {
+        U64 bb = pieceBitboards[pawn] & colorBitboards[color];
+        while (bb) {
+            int sq = getLSB(bb);
+            bb &= bb - 1;
+            key ^= Zobrist::pieces[color*6 + pawn][sq];
+        }
+    }
+    return key;
+}
 
-    zobrist_side_to_move = rng();
+// piece counts packed into materialKey (make/unmake keep it incrementally)
+U64 Board::computeMaterialKey() const {
+    U64 key = 0;
+    for (int color = 0; color < 2; color++)
+        for (int piece = 0; piece < 6; piece++)
+            key += materialUnit(color*6 + piece) * static_cast<U64>(countBits(pieceBitboards[piece] & colorBitboards[color]));
+    return key;
 }
 
-U64 Board::computeZobristHash() {
+U64 Board::computeZobristHash() const {
     U64 hash = 0;
 
-    // Pieces
-    for (int sq = 0; sq < 64; ++sq) {
-        int piece = getMovedPiece(sq);
-        int color = getSideAt(sq);
-        if (piece != -1) {
-            int pieceIndex = (color == 0 ? 0 : 6) + piece;
-            hash ^= zobrist_table[pieceIndex][sq];
+    // Pieces (from the bitboards, so validate() can hold the mailbox against it)
+    for (int color = 0; color < 2; color++) {
+        for (int piece = 0; piece < 6; piece++) {
+            U64 bb = pieceBitboards[piece] & colorBitboards[color];
+            while (bb) {
+                int sq = getLSB(bb);
+                bb &= bb - 1;
+                hash ^= Zobrist::pieces[color*6 + piece][sq];
+            }
         }
     }
 
-    // Side to move
-    if (!is_white_move)
-        hash ^= zobrist_side_to_move;
+    // Side to move (Polyglot: white)
+    if (is_white_move)
+        hash ^= Zobrist::side;
 
     // Castling rights
-    if (currentGameState.HasKingsideCastleRight(true))  hash ^= zobrist_castling[0];
-    if (currentGameState.HasQueensideCastleRight(true)) hash ^= zobrist_castling[1];
-    if (currentGameState.HasKingsideCastleRight(false)) hash ^= zobrist_castling[2];
-    if (currentGameState.HasQueensideCastleRight(false)) hash ^= zobrist_castling[3];
+    if (currentGameState.HasKingsideCastleRight(true))  hash ^= Zobrist::castling[0];
+    if (currentGameState.HasQueensideCastleRight(true)) hash ^= Zobrist::castling[1];
+    if (currentGameState.HasKingsideCastleRight(false)) hash ^= Zobrist::castling[2];
+    if (currentGameState.HasQueensideCastleRight(false)) hash ^= Zobrist::castling[3];
 
-    // En passant
+    // En passant (enPassantFile is only set when a capture is possible)
     int epFile = currentGameState.enPassantFile;
     if (epFile >= 0 && epFile < 8)
-        hash ^= zobrist_enpassant[epFile];
+        hash ^= Zobrist::enpassant[epFile];
 
     return hash;
 }
 
 
-U64 Board::zobristCastlingHash(int castling_rights) {
-    U64 hash = 0;
-    if (castling_rights & 1) hash ^= zobrist_castling[0]; // K
-    if (castling_rights & 2) hash ^= zobrist_castling[1]; // Q
-    if (castling_rights & 4) hash ^= zobrist_castling[2]; // k
-    if (castling_rights & 8) hash ^= zobrist_castling[3]; // q
-    return hash;
-}
-
 void Board::auditZobrist(const Board &other, const std::string &label) const {
     bool mismatch = false;
 
@@ -725,15 +859,15 @@ void Board::auditZobrist(const Board &other, const std::string &label) const {
 
     if (currentGameState.castlingRights != other.currentGameState.castlingRights) {
         std::cerr << label << " Castling rights differ: " 
-                  << currentGameState.castlingRights << " vs " 
-                  << other.currentGameState.castlingRights << "\n";
+                  << int(currentGameState.castlingRights) << " vs " 
+                  << int(other.currentGameState.castlingRights) << "\n";
         mismatch = true;
     }
 
     if (currentGameState.enPassantFile != other.currentGameState.enPassantFile) {
         std::cerr << label << " En-passant file differs: " 
-                  << currentGameState.enPassantFile << " vs " 
-                  << other.currentGameState.enPassantFile << "\n";
+                  << int(currentGameState.enPassantFile) << " vs " 
+                  << int(other.currentGameState.enPassantFile) << "\n";
         mismatch = true;
     }
 
@@ -764,7 +898,7 @@ U64 Board::computePolyglotHash() {
         int piece = getMovedPiece(sq);
         int color = getSideAt(sq);
         if (piece != -1) {
-            U64 key = zobrist_table[polyglotPieceHash(piece, color)][sq];
+            U64 key = Zobrist::pieces[polyglotPieceHash(piece, color)][sq];
             hash ^= key;
             std::cout << "- XOR piece " << piece_label(piece)
                       << " (" << (color==0?"White":"Black") << ") at square " << sq
@@ -775,8 +909,8 @@ U64 Board::computePolyglotHash() {
 
     // Side to move
     if (is_white_move) {
-        hash ^= zobrist_side_to_move;
-        std::cout << "- XOR side to move (White): key=0x" << std::hex << zobrist_side_to_move
+        hash ^= Zobrist::side;
+        std::cout << "- XOR side to move (White): key=0x" << std::hex << Zobrist::side
                   << ", hash now=0x" << hash << std::dec << "\n";
     }
 
@@ -789,9 +923,9 @@ U64 Board::computePolyglotHash() {
     };
     for (auto &c : castling) {
         if (c.right) {
-            hash ^= zobrist_castling[c.idx];
+            hash ^= Zobrist::castling[c.idx];
             std::cout << "- XOR castling " << c.name
-                      << ": key=0x" << std::hex << zobrist_castling[c.idx]
+                      << ": key=0x" << std::hex << Zobrist::castling[c.idx]
                       << ", hash now=0x" << hash << std::dec << "\n";
         }
     }
@@ -801,7 +935,7 @@ U64 Board::computePolyglotHash() {
     if (epFile >= 0 && isEpHashable(epFile, is_white_move)) {
         hash ^= polyglot_enpassant[epFile];
         std::cout << "- XOR en passant file " << epFile
-                  << ": key=0x" << std::hex << zobrist_enpassant[epFile]
+                  << ": key=0x" << std::hex << Zobrist::enpassant[epFile]
                   << ", hash now=0x" << hash << std::dec << "\n";
     }
 
@@ -899,24 +1033,24 @@ void Board::debugZobristDifference(uint64_t current_hash, uint64_t expected_hash
               << ", XOR diff: " << diff << std::dec << "\n";
 
     // Side to move
-    if ((current_hash & zobrist_side_to_move) != (expected_hash & zobrist_side_to_move))
+    if ((current_hash & Zobrist::side) != (expected_hash & Zobrist::side))
         std::cout << "- Side to move differs\n";
 
     // Castling rights
     for (int i = 0; i < 4; ++i)
-        if ((current_hash & zobrist_castling[i]) != (expected_hash & zobrist_castling[i]))
+        if ((current_hash & Zobrist::castling[i]) != (expected_hash & Zobrist::castling[i]))
             std::cout << "- Castling right " << i << " differs\n";
 
     // En passant
     for (int i = 0; i < 8; ++i)
-        if ((current_hash & zobrist_enpassant[i]) != (expected_hash & zobrist_enpassant[i]))
+        if ((current_hash & Zobrist::enpassant[i]) != (expected_hash & Zobrist::enpassant[i]))
             std::cout << "- En passant file " << i << " differs\n";
 
     // Pieces
     for (int piece = 0; piece < 6; ++piece) {
         for (int color = 0; color < 2; ++color) {
             for (int sq = 0; sq < 64; ++sq) {
-                uint64_t key = zobrist_table[(move_color == 0 ? 0 : 6) + piece][sq];
+                uint64_t key = Zobrist::pieces[(move_color == 0 ? 0 : 6) + piece][sq];
                 bool inCurrent = (current_hash & key) != 0;
                 bool inExpected = (expected_hash & key) != 0;
                 if (inCurrent != inExpected)
@@ -5,6 +5,9 @@
 #include <chrono>
 #include <sstream>
 #include <fstream>
+#include <utility>
+#include <charconv>
+#include <cstdio>
 
 
 // ------------------
@@ -17,7 +20,7 @@ GameTracker tracker;
 
 Engine::Engine() {
     game_board = Board();
-    search_board = game_board; //Board(game_board);
+    search_board.cloneForSearch(game_board); //Board(game_board);
 
     movegen = std::make_unique<MoveGenerator>(search_board);
     tt.clear();
@@ -27,12 +30,21 @@ Engine::Engine() {
     evaluator.loadEndgamePST(engine_options.endgame_pst_path);
 
     searcher = std::make_unique<Searcher>(search_board, *movegen, evaluator, nnue, tt);
+    searcher->on_iteration = [this](const SearchResult& res, int depth, const SearchLimits& lim) {
+        print_info(res, depth, lim);
+    };
+    info_buffer.reserve(INFO_BUFFER_RESERVE);
 
     book.load(engine_options.opening_book_path);
 
     g_stats = SearchStats();
 }
 
+Engine::~Engine() {
+    stopSearch();
+    waitForSearch();
+}
+
 
 // ------------------
 // -- Engine State --
@@ -49,8 +61,12 @@ void Engine::clearState() {
     //stats = SearchStats();
     g_stats = SearchStats();
     tt.clear();
+    evaluator.clearPawnTable();
+    searcher->clearHeuristics();
     game_board.setFromFEN(STARTPOS_FEN);
-    search_board = game_board;
+    position_fen.clear();
+    position_moves.clear();
+    search_board.cloneForSearch(game_board);
 }
 
 // -------------------
@@ -64,7 +80,6 @@ void Engine::setOption(const std::string& name, const std::string& value) {
 
     // --------- engine options ---------
     if (name == "Move Overhead") {
-        limits.stopped = false;
         engine_options.MOVE_OVERHEAD_MS = std::stoi(value);
         std::cout << "info string set Move Overhead = " << engine_options.MOVE_OVERHEAD_MS << std::endl;
     } 
@@ -82,6 +97,11 @@ void Engine::setOption(const std::string& name, const std::string& value) {
         engine_options.PONDERING = boolFromString(value);
         std::cout << "info string set Ponder = " << (engine_options.PONDERING ? "true" : "false") << std::endl;
     } 
+    else if (name == "MultiPV") {
+        engine_options.MULTI_PV = std::clamp(std::stoi(value), 1, MAX_MULTI_PV);
+        searcher->multi_pv = engine_options.MULTI_PV;
+        std::cout << "info string set MultiPV = " << engine_options.MULTI_PV << std::endl;
+    }
     else if (name == "UCI_ShowWDL") {
         engine_options.UCI_SHOW_WDL = boolFromString(value);
         std::cout << "info string set UCI_ShowWDL = " << (engine_options.UCI_SHOW_WDL ? "true" : "false") << std::endl;
@@ -203,86 +223,101 @@ void Engine::setOption(const std::string& name, const std::string& value) {
 void Engine::setPosition(const std::string& fen,
                          const std::vector<std::string>& moveStrs)
 {
-    // --- Reset board ---
-    if (fen == "startpos")
-        game_board.setFromFEN(STARTPOS_FEN);
-    else
-        game_board.setFromFEN(fen);
-
-    // ply tracking
-    if (game_board.is_white_move) ply = 1;
-    else ply = 2;
+    // --- Reuse or reset board ---
+    // a GUI resends the whole game every move: if this command only appends to the moves
+    // already on game_board (key unchanged since), play just the new ones
+    size_t applied = position_moves.size();
+    bool extends = fen == position_fen
+                && game_board.zobrist_hash == position_key
+                && moveStrs.size() >= applied
+                && std::equal(position_moves.begin(), position_moves.end(), moveStrs.begin());
+
+    if (!extends) {
+        if (fen == "startpos")
+            game_board.setFromFEN(STARTPOS_FEN);
+        else
+            game_board.setFromFEN(fen);
+
+        // ply tracking
+        if (game_board.is_white_move) ply = 1;
+        else ply = 2;
+
+        position_fen = fen;
+        position_moves.clear();
+        applied = 0;
+    }
 
     // --- Apply moves ---
-    // must interpret uci in context of the board state for ep
-    for (const auto& moveStr : moveStrs) {
-
-        if (moveStr == "null" || moveStr == "NULL" || moveStr == "Null") {
-            Move m = Move::NullMove();
-            game_board.MakeMove();
-            ply++;
-            continue;
-        }
-
-        int start  = algebraic_to_square(moveStr.substr(0, 2));
-        int target = algebraic_to_square(moveStr.substr(2, 2));
-        int flag   = Move::noFlag;
+    for (size_t i = applied; i < moveStrs.size(); i++) {
+        applyUCIMove(moveStrs[i]);
+        position_moves.push_back(moveStrs[i]);
+        ply++;
+    }
+    position_key = game_board.zobrist_hash;
 
-        int movedPiece = game_board.getMovedPiece(start);
-        bool isPawn = (movedPiece == pawn);
+    // --- Sync search board ---
+    search_board.cloneForSearch(game_board); //Board(game_board);
 
-        // ---- Promotion ----
-        if (moveStr.length() == 5) {
-            switch (moveStr[4]) {
-                case 'q': flag = Move::promoteToQueenFlag;  break;
-                case 'r': flag = Move::promoteToRookFlag;   break;
-                case 'b': flag = Move::promoteToBishopFlag; break;
-                case 'n': flag = Move::promoteToKnightFlag; break;
-            }
-        }
+    // --- game handling ---
+    if (mode == EngineMode::GAME) {
+        side = game_board.is_white_move ? EngineSide::WHITE : EngineSide::BLACK;
+        g_gamelog.side = game_board.is_white_move ? "white" : "black";
+    }
 
-        // ---- Castling ----
-        if (movedPiece == king &&
-            (moveStr == "e1g1" || moveStr == "e1c1" ||
-             moveStr == "e8g8" || moveStr == "e8c8")) {
-            flag = Move::castleFlag;
-        }
+    game_over = checkGameEnd();
+}
 
-        // ---- En-passant ----
-        if (isPawn && game_board.currentGameState.enPassantFile != -1) {
-            int epRank   = game_board.is_white_move ? 5 : 2;
-            int epSquare = game_board.currentGameState.enPassantFile + epRank * 8;
-            if (target == epSquare)
-                flag = Move::enPassantCaptureFlag;
-        }
+// must interpret uci in context of the board state for ep
+void Engine::applyUCIMove(const std::string& moveStr) {
+    if (moveStr == "null" || moveStr == "NULL" || moveStr == "Null") {
+        game_board.MakeNullMove();
+        return;
+    }
 
-        // ---- Double pawn push ----
-        if (isPawn && flag == Move::noFlag) {
-            int sr = start / 8;
-            int tr = target / 8;
-            if (std::abs(sr - tr) == 2)
-                flag = Move::pawnTwoUpFlag;
-        }
+    int start  = algebraic_to_square(moveStr.substr(0, 2));
+    int target = algebraic_to_square(moveStr.substr(2, 2));
+    int flag   = Move::noFlag;
 
-        Move m(start, target, flag);
+    int movedPiece = game_board.getMovedPiece(start);
+    bool isPawn = (movedPiece == pawn);
 
-        //if (nnue) nnue->on_make_move(game_board, m);
-        game_board.MakeMove(m);
-        ply++;
+    // ---- Promotion ----
+    if (moveStr.length() == 5) {
+        switch (moveStr[4]) {
+            case 'q': flag = Move::promoteToQueenFlag;  break;
+            case 'r': flag = Move::promoteToRookFlag;   break;
+            case 'b': flag = Move::promoteToBishopFlag; break;
+            case 'n': flag = Move::promoteToKnightFlag; break;
+        }
     }
 
-    game_board.is_in_check = game_board.inCheck(true);
+    // ---- Castling ----
+    if (movedPiece == king &&
+        (moveStr == "e1g1" || moveStr == "e1c1" ||
+         moveStr == "e8g8" || moveStr == "e8c8")) {
+        flag = Move::castleFlag;
+    }
 
-    // --- Sync search board ---
-    search_board = game_board; //Board(game_board);
+    // ---- En-passant ----
+    if (isPawn && game_board.currentGameState.enPassantFile != -1) {
+        int epRank   = game_board.is_white_move ? 5 : 2;
+        int epSquare = game_board.currentGameState.enPassantFile + epRank * 8;
+        if (target == epSquare)
+            flag = Move::enPassantCaptureFlag;
+    }
 
-    // --- game handling ---
-    if (mode == EngineMode::GAME) {
-        side = game_board.is_white_move ? EngineSide::WHITE : EngineSide::BLACK;
-        g_gamelog.side = game_board.is_white_move ? "white" : "black";
+    // ---- Double pawn push ----
+    if (isPawn && flag == Move::noFlag) {
+        int sr = start / 8;
+        int tr = target / 8;
+        if (std::abs(sr - tr) == 2)
+            flag = Move::pawnTwoUpFlag;
     }
 
-    game_over = checkGameEnd();
+    Move m(start, target, flag);
+
+    //if (nnue) nnue->on_make_move(game_board, m);
+    game_board.MakeMove(m);
 }
 
 
@@ -304,12 +339,20 @@ void Engine::computeSearchTime(const SearchSettings& settings) {
     }
 
     int movesToGo = settings.movestogo > 0 ? settings.movestogo : 20;
+    int depthLimit = settings.depth > 0 ? settings.depth : -1;
 
-    // hard coded time/depth
-    if (settings.movetime > 0 || settings.depth > 0) {
+    // analysis: no clock at all (stop / depth / nodes end it)
+    if (settings.infinite) {
+        limits = SearchLimits(0, depthLimit, settings.nodes);
+        return;
+    }
+
+    // hard coded time/depth/nodes/mate (go nodes alone searches without a clock, so it reproduces anywhere)
+    if (settings.movetime > 0 || settings.depth > 0 || settings.nodes > 0 || settings.mate > 0) {
         limits = SearchLimits(
-            settings.movetime - engine_options.MOVE_OVERHEAD_MS,
-            settings.depth
+            settings.movetime > 0 ? std::max(1, settings.movetime - engine_options.MOVE_OVERHEAD_MS) : 0,
+            depthLimit,
+            settings.nodes
         );
         return;
     }
@@ -318,17 +361,22 @@ void Engine::computeSearchTime(const SearchSettings& settings) {
     int side = game_board.is_white_move ? 0 : 1;
     int myTime = (side == 0 ? settings.wtime : settings.btime);
     int myInc  = (side == 0 ? settings.winc  : settings.binc);
+    int available = std::max(1, myTime - engine_options.MOVE_OVERHEAD_MS);
 
-    // compute function
+    // soft (optimum) budget: scaled between iterations by best move stability / node share / score drop
     double aggressiveness = 1.0;
-    int timeBudget = static_cast<int>(
+    int softBudget = static_cast<int>(
         (static_cast<double>(myTime) / movesToGo + myInc / 2.0)
         * aggressiveness
     );
 
-    timeBudget = std::max(10, timeBudget - engine_options.MOVE_OVERHEAD_MS);
+    // hard budget: polled in the tree, never more than a fixed share of the clock
+    int maxShare = movesToGo > 1 ? available / 3 : available * 4 / 5;
+    int hardBudget = std::max(1, std::min(softBudget * 4, maxShare));
+    softBudget = std::clamp(softBudget - engine_options.MOVE_OVERHEAD_MS, 1, hardBudget);
 
-    limits = SearchLimits(timeBudget);
+    limits = SearchLimits(hardBudget, -1, settings.nodes);
+    limits.soft_limit_ms = softBudget;
 }
 
 
@@ -337,7 +385,8 @@ void Engine::startSearch() {
     nnue.build_accumulators(search_board);
 
     // book probe
-    if (!engine_options.opening_book_path.empty()) {
+    // (not for analysis requests: searchmoves / mate want a searched answer)
+    if (!engine_options.opening_book_path.empty() && settings.searchmoves.empty() && settings.mate == 0) {
         uint64_t key = search_board.zobrist_hash;
         auto bookMoves = book.get_moves(key);
 
@@ -360,6 +409,7 @@ void Engine::startSearch() {
             }
 
             bestMove = bestBookMove;
+            ponderMove = Move::NullMove();
             return; // skip search entirely
         }
     }
@@ -370,7 +420,6 @@ void Engine::startSearch() {
     time_left[1] = settings.btime;
     increment[0] = settings.winc;
     increment[1] = settings.binc;
-    pondering = settings.infinite;
 
     // stats tracking
     auto start_time = std::chrono::steady_clock::now();
@@ -384,12 +433,26 @@ void Engine::startSearch() {
     int count = movegen->generateMoves(game_board, false);
     std::copy_n(movegen->moves, count, first_moves);
 
+    // go searchmoves: keep only the listed root moves (none of them legal -> search everything)
+    if (!settings.searchmoves.empty()) {
+        auto listed = [&](const Move& m) {
+            return std::find(settings.searchmoves.begin(), settings.searchmoves.end(), m.uci()) != settings.searchmoves.end();
+        };
+        int kept = static_cast<int>(std::stable_partition(first_moves, first_moves + count, listed) - first_moves);
+        if (kept > 0) count = kept;
+    }
+
     // --- run search ---
     computeSearchTime(settings);
+    limits.stop_request = &stop_requested;
+    limits.mate = settings.mate;
+    limits.on_progress = [this](const SearchLimits& lim) { print_progress(lim); };
+    if (settings.ponder) limits.ponder = &pondering;
     result = searcher->iterativeDeepening(first_moves, count, limits);
     bestMove = result.bestMove;
     bestEval = result.eval; 
     pv_line = result.best_line.line;
+    ponderMove = pv_line.size() > 1 && Move::SameMove(pv_line[0], bestMove) ? pv_line[1] : Move::NullMove();
     //sendBestMove(bestMove);
 
     // finalize cumulative stats
@@ -416,14 +479,51 @@ void Engine::startSearch() {
 }
 
 
+// go: the listener thread keeps reading (stop / isready / quit) while this runs
+void Engine::startSearchThread(bool send_eval) {
+    waitForSearch();
+    stop_requested = false;
+    pondering = settings.ponder; // before the thread starts, so an early ponderhit is not lost
+
+    search_thread = std::thread([this, send_eval]() {
+        startSearch();
+
+        // go infinite / go ponder: bestmove only once the GUI says stop (or ponderhit),
+        // even if the search ended on its own
+        {
+            std::unique_lock<std::mutex> lock(bestmove_mutex);
+            bestmove_cv.wait(lock, [this] {
+                return !(settings.infinite || pondering.load()) || stop_requested.load();
+            });
+        }
+
+        sendBestMove(bestMove, send_eval);
+    });
+}
+
+void Engine::waitForSearch() {
+    if (search_thread.joinable()) search_thread.join();
+}
+
 void Engine::stopSearch() {
-    limits.stopped = true;
+    {
+        // under the lock, so a worker between its check and its wait cannot miss the wake-up
+        std::lock_guard<std::mutex> lock(bestmove_mutex);
+        stop_requested = true;
+    }
+    bestmove_cv.notify_one();
     tracker.result = GameResult::ABORTED;
     tracker.reason = GameEndReason::NONE;
 }
 
+// the opponent played the expected move: the running search becomes the real one,
+// its clock starts now (SearchLimits::clock_running)
 void Engine::ponderHit() {
-    pondering = false;
+    {
+        std::lock_guard<std::mutex> lock(bestmove_mutex);
+        pondering = false;
+    }
+    bestmove_cv.notify_one();
 }
 
 
@@ -431,13 +531,100 @@ void Engine::ponderHit() {
 // -- Communication --
 // -------------------
 
-void Engine::sendBestMove(Move best, bool eval, bool ponder) {
-    if (eval) std::cout << "eval " << bestEval << " ";
-    std::cout << "bestmove " << best.uci();
-    if (ponder) std::cout << " ponder";
-    std::cout << std::endl;
+namespace {
+    void appendInt(std::string& out, int64_t v) {
+        char digits[24];
+        auto res = std::to_chars(digits, digits + sizeof(digits), v);
+        out.append(digits, res.ptr);
+    }
+
+    // UCI score: centipawns, or moves to mate (negative = getting mated)
+    void appendScore(std::string& out, int eval) {
+        if (std::abs(eval) >= MATE_IN_MAX_PLY) {
+            int plies = MATE_SCORE - std::abs(eval);
+            out += "mate ";
+            appendInt(out, eval > 0 ? (plies + 1) / 2 : -(plies / 2));
+        } else {
+            out += "cp ";
+            appendInt(out, eval);
+        }
+    }
+
+    // fields every info line shares: seldepth nodes nps hashfull time
+    void appendStats(std::string& out, const SearchLimits& lim, int hashfull) {
+        int64_t ms = lim.elapsed_ms();
+        out += " seldepth ";  appendInt(out, lim.seldepth);
+        out += " nodes ";     appendInt(out, static_cast<int64_t>(lim.nodes));
+        out += " nps ";       appendInt(out, static_cast<int64_t>(lim.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(ms, 1))));
+        out += " hashfull ";  appendInt(out, hashfull);
+        out += " time ";      appendInt(out, ms);
+    }
+
+    // the whole block in one write (the listener thread may be answering isready at the same time)
+    void flushInfo(const std::string& out) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        std::fflush(stdout);
+    }
+}
 
+// info lines are built in info_buffer (capacity kept between calls) and written once per call
+void Engine::print_info(const SearchResult& res, int depth, const SearchLimits& lim) {
+    int hashfull = tt.hashfull();
+    info_buffer.clear();
+    for (int k = 0; k < res.line_count; ++k) {
+        info_buffer += "info depth ";
+        appendInt(info_buffer, depth);
+        appendStats(info_buffer, lim, hashfull);
+        if (engine_options.MULTI_PV > 1) {
+            info_buffer += " multipv ";
+            appendInt(info_buffer, k + 1);
+        }
+        info_buffer += " score ";
+        appendScore(info_buffer, res.lines[k].eval);
+        info_buffer += " pv";
+        for (const Move& m : res.lines[k].line.line) {
+            info_buffer += ' ';
+            info_buffer += m.uci();
+        }
+        info_buffer += '\n';
+    }
+    flushInfo(info_buffer);
+}
+
+// once a second inside a long iteration: throughput only, the pv comes with the iteration
+void Engine::print_progress(const SearchLimits& lim) {
+    info_buffer.clear();
+    info_buffer += "info depth ";
+    appendInt(info_buffer, lim.depth);
+    appendStats(info_buffer, lim, tt.hashfull());
+    info_buffer += '\n';
+    flushInfo(info_buffer);
+}
+
+void Engine::sendBestMove(Move best, bool eval) {
+    // one write, same path as the info lines: the listener thread may be answering isready at the same time
+    info_buffer.clear();
+    if (eval) {
+        info_buffer += "eval ";
+        appendInt(info_buffer, bestEval);
+        info_buffer += ' ';
+    }
+    info_buffer += "bestmove ";
+    info_buffer += best.uci();
+    if (!Move::SameMove(ponderMove, Move::NullMove()) && Move::SameMove(best, bestMove)) {
+        info_buffer += " ponder ";
+        info_buffer += ponderMove.uci();
+    }
+    info_buffer += '\n';
+    flushInfo(info_buffer);
+
+    // keep the position-command cache in step: the GUI's next list starts with this move
+    bool in_sync = game_board.zobrist_hash == position_key;
     game_board.MakeMove(best);
+    if (in_sync) {
+        position_moves.push_back(best.uci());
+        position_key = game_board.zobrist_hash;
+    }
     game_over = checkGameEnd();
 
     if (mode == EngineMode::GAME) {trackGame();}
@@ -467,19 +654,22 @@ void Engine::newGame() {
 
 
     game_board.setFromFEN(STARTPOS_FEN);
-    search_board = game_board;
+    search_board.cloneForSearch(game_board);
 }
 
 bool Engine::checkGameEnd() {
     if (g_gamelog.finalized) return true;
 
-    if (isCheckmate()) {
+    // one early-exit legality query decides both mate and stalemate
+    bool no_moves = !movegen->hasLegalMoves(game_board);
+
+    if (no_moves && game_board.is_in_check) {
         g_gamelog.outcome =
             !game_board.is_white_move ? GameResult::WHITE_WIN
                                      : GameResult::BLACK_WIN;
         g_gamelog.reason = GameEndReason::CHECKMATE;
     }
-    else if (isStalemate()) {
+    else if (no_moves) {
         g_gamelog.outcome = GameResult::DRAW;
         g_gamelog.reason = GameEndReason::STALEMATE;
     }
@@ -498,7 +688,7 @@ bool Engine::checkGameEnd() {
     // finalize
     g_game_end_time = std::chrono::steady_clock::now();
     g_gamelog.totalTimeSeconds = std::chrono::duration<double>(g_game_end_time - g_game_start_time).count();
-    g_gamelog.moves = game_board.allGameMoves;
+    g_gamelog.moves.assign(game_board.allGameMoves.begin(), game_board.allGameMoves.end());
     g_gamelog.finalEval = nnue.full_eval(game_board);
     logGameLog();
     g_gamelog.finalized = true;
@@ -521,11 +711,11 @@ bool Engine::isStalemate() {
 void Engine::trackGame() {
     tracker.active = true;
     size_t old_count = tracker.playedMoves.size();
-    size_t new_count = game_board.allGameMoves.size();
+    size_t new_count = static_cast<size_t>(game_board.allGameMoves.size());
 
     if (new_count > old_count) {
         for (size_t i = old_count; i < new_count; i++) {
-            tracker.playedMoves.push_back(game_board.allGameMoves[i]);
+            tracker.playedMoves.push_back(game_board.allGameMoves[static_cast<int>(i)]);
         }
     }
 }
@@ -629,6 +819,7 @@ void Engine::create_config_file(std::string config_name) {
 
 // TESTING
 
+// plain single-threaded perft (no bulk count / hash): exercises every make/unmake
 uint64_t Engine::perft(int depth) {
     //ScopedTimer timer(T_PERFT);
     if (depth == 0) {return 1;}
@@ -654,42 +845,154 @@ uint64_t Engine::perft(int depth) {
     return nodes;
 }
 
-void Engine::perftPrint(int depth) {   
-    if (depth == 0) {std::cout << "1" << std::endl;}
+void Engine::perftPrint(int depth, int threads, size_t hash_mb) {
+    PerftResult res = runPerft(search_board, depth, threads, hash_mb);
 
-    unsigned long long nodes = 0;
+    uint64_t nps = res.time_ms ? res.nodes * 1000 / res.time_ms : 0;
+    std::cout << "Nodes searched: " << res.nodes << std::endl;
+    std::cout << "Time: " << res.time_ms << " ms  NPS: " << nps << std::endl;
+    logTimingStats(game_board.getBoardFEN());
+}
 
-    Move moves[MAX_MOVES];
-    int count = movegen->generateMoves(search_board, false);
-    std::copy_n(movegen->moves, count, moves);
+void Engine::perftDivide(int depth, int threads, size_t hash_mb) {
+    PerftResult res = runPerft(search_board, depth, threads, hash_mb);
 
-    Move* end = moves + count;
-    for (Move* m = moves; m < end; ++m) {
-        search_board.MakeMove(*m);
-        nodes += perft(depth - 1);
-        search_board.UnmakeMove(*m);
+    for (const auto& [move, n] : res.divide)
+        std::cout << move.uci() << ": " << n << "\n";
+
+    std::cout << "Total: " << res.nodes << "\n";
+}
+
+// runs every listed depth (<= settings.max_depth) of an EPD perft suite
+void Engine::perftSuite(const fs::path& file, const PerftSuiteSettings& settings) {
+    std::ifstream in(file);
+    if (!in.is_open()) {
+        std::cout << "info string cannot open " << file.string() << std::endl;
+        return;
     }
 
-    std::cout << "Nodes searched: " << nodes << std::endl;
-    logTimingStats(game_board.getBoardFEN());
+    // opt-in hash: allocated once, cleared per position (depths of one position still share it)
+    std::unique_ptr<PerftTable> table;
+    if (settings.hash_mb > 0) table = std::make_unique<PerftTable>(settings.hash_mb);
+    const int max_depth = settings.max_depth;
+    int positions = 0, passed = 0;
+    uint64_t total_nodes = 0, total_ms = 0;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t semi = line.find(';');
+        if (line.empty() || semi == std::string::npos) continue;
+
+        PerftSuiteEntry entry;
+        entry.fen = line.substr(0, semi);
+        while (!entry.fen.empty() && entry.fen.back() == ' ') entry.fen.pop_back();
+
+        auto board = std::make_unique<Board>(entry.fen);
+        if (table) table->clear();
+
+        // "; D<depth> <nodes>" fields
+        std::istringstream fields(line.substr(semi));
+        std::string tok;
+        while (std::getline(fields, tok, ';')) {
+            std::istringstream f(tok);
+            std::string d;
+            uint64_t expected = 0;
+            if (!(f >> d >> expected) || d.size() < 2 || d[0] != 'D') continue;
+
+            int depth = std::stoi(d.substr(1));
+            if (max_depth > 0 && depth > max_depth) continue;
+
+            PerftResult res = runPerft(*board, depth, settings.threads, table.get());
+
+            PerftDepthResult dr{depth, expected, res.nodes, res.time_ms, res.nodes == expected};
+            entry.depths.push_back(dr);
+            entry.nodes += res.nodes;
+            entry.time_ms += res.time_ms;
+            entry.pass = entry.pass && dr.pass;
+        }
+        if (entry.depths.empty()) continue;
+
+        positions++;
+        passed += entry.pass;
+        total_nodes += entry.nodes;
+        total_ms += entry.time_ms;
+
+        uint64_t nps = entry.time_ms ? entry.nodes * 1000 / entry.time_ms : 0;
+        std::cout << (entry.pass ? "PASS " : "FAIL ") << std::setw(4) << positions
+                  << "  D" << entry.depths.front().depth << "-D" << entry.depths.back().depth
+                  << "  nodes " << entry.nodes << "  time " << entry.time_ms << " ms"
+                  << "  nps " << nps << "  " << entry.fen << "\n";
+        for (const auto& dr : entry.depths) {
+            if (!dr.pass)
+                std::cout << "    D" << dr.depth << " expected " << dr.expected << " got " << dr.nodes << "\n";
+        }
+
+        logPerftEntry(entry, settings);
+    }
+
+    uint64_t nps = total_ms ? total_nodes * 1000 / total_ms : 0;
+    // positions count only those with a listed depth under the cap
+    std::cout << "Perft suite: " << passed << "/" << positions << " passed"
+              << "  (depth <= " << (max_depth > 0 ? std::to_string(max_depth) : "all")
+              << ", threads " << settings.threads << ", hash " << settings.hash_mb << " MB)"
+              << "  nodes " << total_nodes << "  time " << total_ms << " ms"
+              << "  nps " << nps << std::endl;
+
+    logPerftSummary(file.string(), settings, positions, passed, total_nodes, total_ms);
 }
 
-void Engine::perftDivide(int depth) {
-    int count = movegen->generateMoves(search_board, false);
-    Move* moves = movegen->moves;
+// -------------------------------
+// Bench
+// -------------------------------
+// same positions, depth and fresh tables every run: the node count is a fingerprint of the
+// search (changes only with search changes), nps the speed figure
+
+namespace {
+    const char* BENCH_FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1bq1rk1/pp2bppp/2n2n2/2pp4/3P4/2PBPN2/PP1N1PPP/R2QK2R w KQ - 0 9",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "2r3k1/pp3ppp/2n1b3/3pP3/3P4/P1qB1N2/5PPP/R2Q1RK1 w - - 0 18",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "8/8/4k3/3p4/3P1K2/8/5P2/8 w - - 0 1",
+    };
+}
 
-    unsigned long long total = 0;
+void Engine::bench(int depth) {
+    uint64_t total_nodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto report = std::exchange(searcher->on_iteration, nullptr); // totals only
 
-    for (int i = 0; i < count; i++) {
-        search_board.MakeMove(moves[i]);
-        uint64_t n = perft(depth - 1);
-        search_board.UnmakeMove(moves[i]);
+    for (const char* fen : BENCH_FENS) {
+        tt.clear();
+        evaluator.clearPawnTable();
+        searcher->clearHeuristics();
+        game_board.setFromFEN(fen);
+        search_board.cloneForSearch(game_board);
 
-        std::cout << moves[i].uci() << ": " << n << "\n";
-        total += n;
+        Move first_moves[MAX_MOVES];
+        int count = movegen->generateMoves(game_board, false);
+        std::copy_n(movegen->moves, count, first_moves);
+
+        SearchLimits bench_limits(0, depth);
+        bench_limits.stop_request = &stop_requested;
+        SearchResult res = searcher->iterativeDeepening(first_moves, count, bench_limits);
+        total_nodes += bench_limits.nodes;
+
+        std::cout << "info string bench " << fen << "  nodes " << bench_limits.nodes
+                  << "  bestmove " << res.bestMove.uci() << std::endl;
     }
 
-    std::cout << "Total: " << total << "\n";
+    uint64_t ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    std::cout << "Nodes searched: " << total_nodes << std::endl;
+    std::cout << "Time: " << ms << " ms  NPS: " << (ms ? total_nodes * 1000 / ms : 0) << std::endl;
+
+    // leave the engine as after ucinewgame
+    searcher->on_iteration = std::move(report);
+    clearState();
 }
 
 void Engine::SEETest(int capture_square) {
@@ -745,15 +1048,13 @@ void Engine::moveOrderingTest(int depth) {
 
     // Use empty TT and PV for testing at root
     Move ttMove;               // assume default-constructed = no move
-    std::vector<Move> previousPV;
 
     for (int i = 0; i < moveCount; ++i) {
         int score = searcher->moveScore(
             moves[i], 
             search_board, 
             0,        // ply 0 at root
-            ttMove, 
-            previousPV
+            ttMove
         );
         scoredMoves.emplace_back(moves[i], score);
     }
@@ -769,3 +1070,146 @@ void Engine::moveOrderingTest(int depth) {
     }
 }
 
+
+// --------------------------------
+// selftest: regression checks that need no external files
+// --------------------------------
+
+namespace {
+    // a stopped search must not leave half-searched nodes in the TT: stop a quiet middlegame
+    // search at a sweep of node budgets (many land inside a null-move search) and look for
+    // mate bounds, which no node this close to that position can honestly hold
+    std::string checkStoppedSearchTT(Engine& engine) {
+        const char* fen = "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
+        engine.game_board.setFromFEN(fen);
+
+        Move first_moves[MAX_MOVES];
+        int count = engine.movegen->generateMoves(engine.game_board, false);
+        std::copy_n(engine.movegen->moves, count, first_moves);
+
+        for (uint64_t budget = 100; budget <= 20000; budget += 97) {
+            engine.tt.clear();
+            engine.searcher->clearHeuristics();
+            engine.search_board.cloneForSearch(engine.game_board);
+
+            SearchLimits limits(0, -1, budget);
+            engine.searcher->iterativeDeepening(first_moves, count, limits);
+
+            for (size_t i = 0; i < engine.tt.entriesCount; ++i) {
+                const TTEntry& e = engine.tt.slot(i);
+                if (e.key && std::abs(e.eval) >= MATE_IN_MAX_PLY)
+                    return "mate bound " + std::to_string(e.eval) + " stored by a search stopped at "
+                           + std::to_string(budget) + " nodes";
+            }
+        }
+        return "";
+    }
+
+    // validate() must catch each kind of corruption, and name the right invariant:
+    // one field broken per case, everything else kept consistent with it
+    std::string checkValidateCatchesCorruption(Engine&) {
+        const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+        struct Corruption {
+            const char* name;
+            const char* fen;
+            const char* expect; // substring of the validate() reason
+            void (*apply)(Board&);
+        };
+        const Corruption cases[] = {
+            {"zobrist key", kiwipete, "zobrist_hash",
+                [](Board& b) { b.zobrist_hash ^= 1ULL; }},
+            {"material key", kiwipete, "materialKey",
+                [](Board& b) { b.materialKey += Position::materialUnit(queen); }},
+            {"pawn key", kiwipete, "pawnKey",
+                [](Board& b) { b.pawnKey ^= 1ULL; }},
+            {"key history", kiwipete, "keyHistory",
+                [](Board& b) { b.keyHistory.back() ^= 1ULL; }},
+            {"color occupancy", kiwipete, "do not cover",
+                [](Board& b) { set_bit(b.colorBitboards[0], d3); }},
+            {"mailbox", kiwipete, "sqToPiece",
+                [](Board& b) { b.sqToPiece[d3] = knight; }},
+            {"king count", kiwipete, "exactly one king",
+                [](Board& b) {
+                    set_bit(b.pieceBitboards[king], d3);
+                    set_bit(b.colorBitboards[0], d3);
+                    b.sqToPiece[d3] = king;
+                }},
+            {"castling rights", "r3k3/8/8/8/8/8/8/R3K2R w KQq - 0 1", "castling right",
+                [](Board& b) {
+                    b.currentGameState.castlingRights |= 0b0100; // black king side, no h8 rook
+                    b.zobrist_hash = b.computeZobristHash();
+                    b.keyHistory.back() = b.zobrist_hash;
+                }},
+        };
+
+        for (const auto& c : cases) {
+            auto board = std::make_unique<Board>(c.fen);
+            std::string why;
+            if (!board->validate(&why)) return std::string(c.name) + ": clean position rejected (" + why + ")";
+
+            c.apply(*board);
+            if (board->validate(&why)) return std::string(c.name) + ": corruption not detected";
+            if (why.find(c.expect) == std::string::npos)
+                return std::string(c.name) + ": reported as \"" + why + "\"";
+        }
+        return "";
+    }
+
+    // loading a position keeps only the castling rights its kings and rooks still back up,
+    // whether it comes from a FEN or from a hand-built / corrupt packed record
+    std::string checkLoadDropsImpossibleCastling(Engine&) {
+        struct Load {
+            const char* fen;
+            int extra_rights; // forced into the packed record on top of the FEN's
+            int expected;     // rights after the load
+        };
+        const Load loads[] = {
+            {"r3k3/8/8/8/8/8/8/R3K2R w KQkq - 0 1", 0b0000, 0b1011}, // no h8 rook: k dropped
+            {"r3k2r/8/8/8/8/8/8/R4K1R w KQkq - 0 1", 0b0000, 0b1100}, // king off e1: K and Q dropped
+            {"r3k3/8/8/8/8/8/8/R3K2R w KQq - 0 1",   0b0100, 0b1011}, // record claims k anyway
+            {"4k3/8/8/8/8/8/8/4K3 w - - 0 1",        0b1111, 0b0000}, // no rooks at all
+        };
+
+        for (const auto& l : loads) {
+            auto board = std::make_unique<Board>(l.fen);
+            std::string why;
+            if (board->currentGameState.castlingRights != l.expected)
+                return std::string("FEN ") + l.fen + ": rights " + std::to_string(board->currentGameState.castlingRights);
+
+            PackedPosition packed = board->pack();
+            packed.bytes[24] |= static_cast<uint8_t>(l.extra_rights << 1);
+            if (!board->unpack(packed)) return std::string("record rejected: ") + l.fen;
+            if (board->currentGameState.castlingRights != l.expected)
+                return std::string("unpack ") + l.fen + ": rights " + std::to_string(board->currentGameState.castlingRights);
+            if (!board->validate(&why)) return std::string("unpack ") + l.fen + ": " + why;
+        }
+        return "";
+    }
+}
+
+bool Engine::selfTest() {
+    const std::pair<const char*, std::string (*)(Engine&)> checks[] = {
+        {"stopped search leaves no TT entry", checkStoppedSearchTT},
+        {"validate reports each corrupted invariant", checkValidateCatchesCorruption},
+        {"load drops castling rights without king and rook", checkLoadDropsImpossibleCastling},
+    };
+
+    auto report = std::exchange(searcher->on_iteration, nullptr);
+    tt.resize(1); // swept searches clear the table every run
+
+    int failed = 0;
+    for (const auto& [name, check] : checks) {
+        std::string why = check(*this);
+        if (why.empty()) std::cout << "selftest " << name << ": ok" << std::endl;
+        else std::cout << "selftest " << name << ": FAILED (" << why << ")" << std::endl;
+        failed += !why.empty();
+    }
+    std::cout << "selftest " << (failed ? "FAILED " : "passed ") << (std::size(checks) - failed)
+              << "/" << std::size(checks) << std::endl;
+
+    // leave the engine as after ucinewgame
+    searcher->on_iteration = std::move(report);
+    tt.resize(static_cast<size_t>(engine_options.HASH_SIZE_MB));
+    clearState();
+    return failed == 0;
+}
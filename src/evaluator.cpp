@@ -105,18 +105,12 @@ int Evaluator::gamePhase(const Board& board) {
 
     int phase = total_phase;
 
-    // Count remaining pieces
-    int wp = countBits(board.colorBitboards[0] & board.pieceBitboards[0]);
-    int wn = countBits(board.colorBitboards[0] & board.pieceBitboards[1]);
-    int wb = countBits(board.colorBitboards[0] & board.pieceBitboards[2]);
-    int wr = countBits(board.colorBitboards[0] & board.pieceBitboards[3]);
-    int wq = countBits(board.colorBitboards[0] & board.pieceBitboards[4]);
-
-    int bp = countBits(board.colorBitboards[1] & board.pieceBitboards[0]);
-    int bn = countBits(board.colorBitboards[1] & board.pieceBitboards[1]);
-    int bb = countBits(board.colorBitboards[1] & board.pieceBitboards[2]);
-    int br = countBits(board.colorBitboards[1] & board.pieceBitboards[3]);
-    int bq = countBits(board.colorBitboards[1] & board.pieceBitboards[4]);
+    // Count remaining pieces (board keeps the counts in materialKey)
+    int wp = board.pieceCount(pawn, 0),   bp = board.pieceCount(pawn, 1);
+    int wn = board.pieceCount(knight, 0), bn = board.pieceCount(knight, 1);
+    int wb = board.pieceCount(bishop, 0), bb = board.pieceCount(bishop, 1);
+    int wr = board.pieceCount(rook, 0),   br = board.pieceCount(rook, 1);
+    int wq = board.pieceCount(queen, 0),  bq = board.pieceCount(queen, 1);
 
     phase -= (wp + bp) * pawn_phase;
     phase -= (wn + bn) * knight_phase;
@@ -242,11 +236,11 @@ int Evaluator::materialDifferences(const Board& board) {
 
     for (int side = 0; side < 2; side++) {
         for (int piece = 0; piece < 5; piece++) { // exclude king
-            U64 bb = board.colorBitboards[side] & board.pieceBitboards[piece];
-            pEval += ((side == 0) ? 1 : -1) * pieceValues[piece] * countBits(bb);
+            int count = board.pieceCount(piece, side);
+            pEval += ((side == 0) ? 1 : -1) * pieceValues[piece] * count;
 
             // Bishop pair bonus
-            if (piece == bishop && countBits(bb) == 2) {
+            if (piece == bishop && count == 2) {
                 pEval += (side == 0) ? 40 : -40;
             }
         }
@@ -261,15 +255,7 @@ int Evaluator::materialDifferences(const Board& board) {
  * Evaluate doubled and isolated pawns.
  */
 int Evaluator::pawnStructureDifferences(const Board& board) {
-    int psEval = 0;
-    U64 pawns = board.pieceBitboards[pawn];
-    U64 white = board.colorBitboards[0];
-    U64 black = board.colorBitboards[1];
-
-    psEval += countDoubledPawns(pawns & white) - countDoubledPawns(pawns & black);
-    psEval += countIsolatedPawns(pawns & white) - countIsolatedPawns(pawns & black);
-
-    return psEval;
+    return probePawns(board).structure;
 }
 
 /** Count doubled pawns on a given color bitboard */
@@ -390,62 +376,116 @@ bool Evaluator::isPassedPawn(bool white, int sq, U64 oppPawns) {
     return (oppPawns & mask) == 0;
 }
 
-/** Evaluate passed pawns difference */
+/** Evaluate passed pawns difference (pawn-only part cached, king distances per call) */
 int Evaluator::passedPawnDifferences(const Board& board) {
-    U64 white_pawns = board.colorBitboards[0] & board.pieceBitboards[pawn];
-    U64 black_pawns = board.colorBitboards[1] & board.pieceBitboards[pawn];
-
+    const PawnEntry& entry = probePawns(board);
     int pp_white = 0, pp_black = 0;
 
-    int white_king_sq = sqidx(board.colorBitboards[0] & board.pieceBitboards[king]);
-    int black_king_sq = sqidx(board.colorBitboards[1] & board.pieceBitboards[king]);
+    int white_king_sq = board.kingSquare(true);
+    int black_king_sq = board.kingSquare(false);
 
-    // White pawns
-    while (white_pawns) {
-        int sq = getLSB(white_pawns);
-        white_pawns &= white_pawns - 1;
+    U64 white_passed = entry.passed[0];
+    while (white_passed) {
+        int sq = getLSB(white_passed);
+        white_passed &= white_passed - 1;
 
-        if (isPassedPawn(true, sq, black_pawns)) {
-            int rank = sq / 8;
-            pp_white += passedBonus[rank];
-            if (white_pawns & PrecomputedMoveData::fullPawnAttacks[sq][1]) pp_white += 20;
+        int rank = sq / 8;
+        int own_dist = PrecomputedMoveData::kingMoveDistances[sq][white_king_sq];
+        int opp_dist = PrecomputedMoveData::kingMoveDistances[sq][black_king_sq];
+        pp_white += std::max(0, 30 - 5 * own_dist);
+        pp_white -= (opp_dist <= (7 - rank)) ? 20 : 0;
+    }
 
-            int own_dist = PrecomputedMoveData::kingMoveDistances[sq][white_king_sq];
-            int opp_dist = PrecomputedMoveData::kingMoveDistances[sq][black_king_sq];
-            pp_white += std::max(0, 30 - 5 * own_dist);
-            pp_white -= (opp_dist <= (7 - rank)) ? 20 : 0;
-        }
+    U64 black_passed = entry.passed[1];
+    while (black_passed) {
+        int sq = getLSB(black_passed);
+        black_passed &= black_passed - 1;
+
+        int rank = sq / 8;
+        int own_dist = PrecomputedMoveData::kingMoveDistances[sq][black_king_sq];
+        int opp_dist = PrecomputedMoveData::kingMoveDistances[sq][white_king_sq];
+        pp_black += std::max(0, 30 - 5 * own_dist);
+        pp_black -= (opp_dist <= rank) ? 20 : 0;
     }
 
-    // re init
-    white_pawns = board.colorBitboards[0] & board.pieceBitboards[pawn];
+    return entry.passedScore + pp_white - pp_black;
+}
+
+// -------------------- PAWN HASH --------------------
+
+/**
+ * Pawn hash lookup: on a miss recompute structure + passed pawns for the pawn key,
+ * then refresh the king-shield terms for any king that is not where they were computed.
+ */
+PawnEntry& Evaluator::probePawns(const Board& board) {
+    PawnEntry& entry = pawnTable[board.pawnKey & (PAWN_HASH_ENTRIES - 1)];
+
+    if (!entry.filled || entry.key != board.pawnKey) {
+        U64 white_pawns = board.colorBitboards[0] & board.pieceBitboards[pawn];
+        U64 black_pawns = board.colorBitboards[1] & board.pieceBitboards[pawn];
+
+        int structure = countDoubledPawns(white_pawns) - countDoubledPawns(black_pawns)
+                      + countIsolatedPawns(white_pawns) - countIsolatedPawns(black_pawns);
 
-    // Black pawns
-    while (black_pawns) {
-        int sq = getLSB(black_pawns);
-        black_pawns &= black_pawns - 1;
+        // passed pawns: rank bonus + protected bonus (same scan order as before the cache)
+        int pp_white = 0, pp_black = 0;
+        U64 passed[2] = {0ULL, 0ULL};
 
-        if (isPassedPawn(false, sq, white_pawns)) {
-            int rank = sq / 8;
-            pp_black += passedBonus[7 - rank];
-            if (black_pawns & PrecomputedMoveData::fullPawnAttacks[sq][0]) pp_black += 20;
+        U64 pawns = white_pawns;
+        while (pawns) {
+            int sq = getLSB(pawns);
+            pawns &= pawns - 1;
 
-            int own_dist = PrecomputedMoveData::kingMoveDistances[sq][black_king_sq];
-            int opp_dist = PrecomputedMoveData::kingMoveDistances[sq][white_king_sq];
-            pp_black += std::max(0, 30 - 5 * own_dist);
-            pp_black -= (opp_dist <= rank) ? 20 : 0;
+            if (isPassedPawn(true, sq, black_pawns)) {
+                passed[0] |= 1ULL << sq;
+                pp_white += passedBonus[sq / 8];
+                if (pawns & PrecomputedMoveData::fullPawnAttacks[sq][1]) pp_white += 20;
+            }
         }
+
+        pawns = black_pawns;
+        while (pawns) {
+            int sq = getLSB(pawns);
+            pawns &= pawns - 1;
+
+            if (isPassedPawn(false, sq, white_pawns)) {
+                passed[1] |= 1ULL << sq;
+                pp_black += passedBonus[7 - sq / 8];
+                if (pawns & PrecomputedMoveData::fullPawnAttacks[sq][0]) pp_black += 20;
+            }
+        }
+
+        entry.key = board.pawnKey;
+        entry.filled = true;
+        entry.structure = static_cast<int16_t>(structure);
+        entry.passedScore = static_cast<int16_t>(pp_white - pp_black);
+        entry.passed[0] = passed[0];
+        entry.passed[1] = passed[1];
+        entry.kingSq[0] = entry.kingSq[1] = -1;
     }
 
-    return pp_white - pp_black;
+    for (int c = 0; c < 2; c++) {
+        int king_sq = board.currentGameState.kingSquare[c];
+        if (entry.kingSq[c] == king_sq) continue;
+        entry.kingSq[c] = static_cast<int8_t>(king_sq);
+        entry.shield[c] = static_cast<int16_t>(kingShield(board, c == 0));
+        entry.openFiles[c] = static_cast<int16_t>(openFilesNearKing(board, c == 0));
+    }
+
+    return entry;
+}
+
+void Evaluator::clearPawnTable() {
+    std::fill(pawnTable.begin(), pawnTable.end(), PawnEntry{});
 }
 
 // -------------------- KING SAFETY --------------------
 
 /** Evaluate king safety for one side */
 int Evaluator::kingSafety(const Board& board, bool usWhite) {
-    int shield_penalty = kingShield(board, usWhite);        // missing pawns
-    int open_penalty = openFilesNearKing(board, usWhite);   // open/semi-open files
+    const PawnEntry& pawns = probePawns(board);
+    int shield_penalty = pawns.shield[usWhite ? 0 : 1];      // missing pawns
+    int open_penalty = pawns.openFiles[usWhite ? 0 : 1];     // open/semi-open files
     int threat_score = tropism(board, !usWhite);            // attackers nearby
 
     // Scale down each component
@@ -571,12 +611,11 @@ bool Evaluator::isSemiOpenFile(const Board& board, int file, bool usWhite) {
 
 int Evaluator::attackerMaterial(const Board& board, int opp_side) {
     int mat = 0;
-    U64 bb = board.colorBitboards[opp_side];
 
-    mat += 300 * countBits(bb & board.pieceBitboards[knight]);
-    mat += 300 * countBits(bb & board.pieceBitboards[bishop]);
-    mat += 500 * countBits(bb & board.pieceBitboards[rook]);
-    mat += 900 * countBits(bb & board.pieceBitboards[queen]);
+    mat += 300 * board.pieceCount(knight, opp_side);
+    mat += 300 * board.pieceCount(bishop, opp_side);
+    mat += 500 * board.pieceCount(rook, opp_side);
+    mat += 900 * board.pieceCount(queen, opp_side);
 
     return mat;
 }
@@ -615,6 +654,11 @@ int Evaluator::SEE(const Board& board, const Move& move) {
     // Used attackers mask
     U64 used = (1ULL << from);
 
+    // pieces pinned to their own king (cached per make) may only recapture along the pin line
+    const GameState& st = board.currentGameState;
+    const U64 pinned[2] = { st.blockersForKing[0] & board.colorBitboards[0],
+                            st.blockersForKing[1] & board.colorBitboards[1] };
+
     // Track current target piece
     int targetPt12 = moverPt12;
 
@@ -663,6 +707,14 @@ int Evaluator::SEE(const Board& board, const Move& move) {
             }
         }
 
+        U64 pinned_attackers = attackers & pinned[side];
+        while (pinned_attackers) {
+            int sqFrom = getLSB(pinned_attackers);
+            pinned_attackers &= pinned_attackers - 1;
+            if (!(PrecomputedMoveData::alignMasks[sqFrom][st.kingSquare[side]] & (1ULL << sq)))
+                attackers &= ~(1ULL << sqFrom);
+        }
+
         return attackers;
     };
 
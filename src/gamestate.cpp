@@ -16,15 +16,23 @@ GameState::GameState() {
     capturedPieceType = -1;
     enPassantFile = -1;
     castlingRights = 0b1111;
+    kingSquare[0] = kingSquare[1] = -1;
     fiftyMoveCounter = 0;
+    pliesFromNull = 0;
+    checkers = 0ULL;
+    blockersForKing[0] = blockersForKing[1] = 0ULL;
     //was_in_check = false;
 }
 
 GameState::GameState(int capture_piece, int en_passant_file, int castling_rights, int fifty_move_count) {
-    capturedPieceType = capture_piece;
-    enPassantFile = en_passant_file;
-    castlingRights = castling_rights;
-    fiftyMoveCounter = fifty_move_count;
+    capturedPieceType = static_cast<int8_t>(capture_piece);
+    enPassantFile = static_cast<int8_t>(en_passant_file);
+    castlingRights = static_cast<int8_t>(castling_rights);
+    kingSquare[0] = kingSquare[1] = -1;
+    fiftyMoveCounter = static_cast<int16_t>(fifty_move_count);
+    pliesFromNull = 0;
+    checkers = 0ULL;
+    blockersForKing[0] = blockersForKing[1] = 0ULL;
     //was_in_check = false;
 }
 
@@ -41,9 +49,9 @@ bool GameState::HasQueensideCastleRight(bool white) const {
 //int GameState::FiftyMoveCounter() const { return fiftyMoveCounter; }
 
 void GameState::PrintGamestate() {
-    std::cout << "Captured Piece: " << capturedPieceType << std::endl;
-    std::cout << "En-passant File: " << enPassantFile << std::endl;
-    std::cout << "Castling Rights: " << castlingRights << std::endl;
-    std::cout << "50 move counter: " << fiftyMoveCounter << std::endl;
+    std::cout << "Captured Piece: " << int(capturedPieceType) << std::endl;
+    std::cout << "En-passant File: " << int(enPassantFile) << std::endl;
+    std::cout << "Castling Rights: " << int(castlingRights) << std::endl;
+    std::cout << "50 move counter: " << int(fiftyMoveCounter) << std::endl;
 }
 
@@ -1,18 +1,9 @@
 #include <magics.h>
 
 namespace Magics {
-    U64 rookAttackTable[64][4096]; // size must be 2^maxBits = 2^12
-    U64 bishopAttackTable[64][512]; // size must be 2^maxBits = 2^9
-    U64 rookMasks[64];
-    U64 bishopMasks[64];
-    U64 rookMagics[64];
-    U64 bishopMagics[64];
-    int rookShifts[64];
-    int bishopShifts[64];
-
     // Known-good magic numbers (from Surge engine, public domain)
     // These work at standard bit counts (popcount of mask)
-    static constexpr U64 ROOK_MAGICS_CONST[64] = {
+    constexpr std::array<U64, 64> rookMagics = {
         0x0080001020400080ULL, 0x0040001000200040ULL, 0x0080081000200080ULL, 0x0080040800100080ULL,
         0x0080020400080080ULL, 0x0080010200040080ULL, 0x0080008001000200ULL, 0x0080002040800100ULL,
         0x0000800020400080ULL, 0x0000400020005000ULL, 0x0000801000200080ULL, 0x0000800800100080ULL,
@@ -31,7 +22,7 @@ namespace Magics {
         0x0001000204080011ULL, 0x0001000204000801ULL, 0x0001000082000401ULL, 0x0001FFFAABFAD1A2ULL
     };
 
-    static constexpr U64 BISHOP_MAGICS_CONST[64] = {
+    constexpr std::array<U64, 64> bishopMagics = {
         0x0002020202020200ULL, 0x0002020202020000ULL, 0x0004010202000000ULL, 0x0004040080000000ULL,
         0x0001104000000000ULL, 0x0000821040000000ULL, 0x0000410410400000ULL, 0x0000104104104000ULL,
         0x0000040404040400ULL, 0x0000020202020200ULL, 0x0000040102020000ULL, 0x0000040400800000ULL,
@@ -49,167 +40,163 @@ namespace Magics {
         0x0000104104104000ULL, 0x0000002082082000ULL, 0x0000000020841000ULL, 0x0000000000208800ULL,
         0x0000000010020200ULL, 0x0000000404080200ULL, 0x0000040404040400ULL, 0x0002020202020200ULL
     };
-    
-    void initMagics() {
-        for (int sq = 0; sq < 64; ++sq) {
-            // Rook
-            rookMasks[sq] = maskRook(sq);
-            int rookBits = __builtin_popcountll(rookMasks[sq]);
-            rookShifts[sq] = 64 - rookBits;
-            rookMagics[sq] = ROOK_MAGICS_CONST[sq];
-
-            std::vector<U64> occupancies = generateAllOccupancies(rookMasks[sq]);
-            for (size_t i = 0; i < occupancies.size(); ++i) {
-                size_t index = (occupancies[i] * rookMagics[sq]) >> rookShifts[sq];
-                rookAttackTable[sq][index] = rookAttacksOnTheFly(sq, occupancies[i]);
-            }
-
-            // Bishop
-            bishopMasks[sq] = maskBishop(sq);
-            int bishopBits = __builtin_popcountll(bishopMasks[sq]);
-            bishopShifts[sq] = 64 - bishopBits;
-            bishopMagics[sq] = BISHOP_MAGICS_CONST[sq];
-
-            std::vector<U64> bOccupancies = generateAllOccupancies(bishopMasks[sq]);
-            for (size_t i = 0; i < bOccupancies.size(); ++i) {
-                size_t index = (bOccupancies[i] * bishopMagics[sq]) >> bishopShifts[sq];
-                bishopAttackTable[sq][index] = bishopAttacksOnTheFly(sq, bOccupancies[i]);
-            }
-        }
-    }
 
+    // ---------------- compile-time table generation ----------------
+    // Everything in here only runs inside constant expressions: the tables land in
+    // read-only data and there is no startup work left to do.
+    namespace {
 
-    // relevant occupancy masks
-    U64 maskRook(int sq) {
-        U64 mask = 0ULL;
-        int rank = sq / 8;
-        int file = sq % 8;
+        // relevant occupancy masks
+        constexpr U64 maskRook(int sq) {
+            U64 mask = 0ULL;
+            int rank = sq / 8;
+            int file = sq % 8;
 
-        // Horizontal (left to right, excluding edges)
-        for (int f = file + 1; f <= 6; f++) mask |= (1ULL << (rank * 8 + f));
-        for (int f = file - 1; f >= 1; f--) mask |= (1ULL << (rank * 8 + f));
+            // Horizontal (left to right, excluding edges)
+            for (int f = file + 1; f <= 6; f++) mask |= (1ULL << (rank * 8 + f));
+            for (int f = file - 1; f >= 1; f--) mask |= (1ULL << (rank * 8 + f));
 
-        // Vertical (up and down, excluding edges)
-        for (int r = rank + 1; r <= 6; r++) mask |= (1ULL << (r * 8 + file));
-        for (int r = rank - 1; r >= 1; r--) mask |= (1ULL << (r * 8 + file));
+            // Vertical (up and down, excluding edges)
+            for (int r = rank + 1; r <= 6; r++) mask |= (1ULL << (r * 8 + file));
+            for (int r = rank - 1; r >= 1; r--) mask |= (1ULL << (r * 8 + file));
 
-        return mask;
-    }
-    U64 maskBishop(int sq) {
-        U64 mask = 0ULL;
-        int rank = sq / 8;
-        int file = sq % 8;
-
-        // Diagonal ↘↖ (exclude edges)
-        for (int r = rank + 1, f = file + 1; r <= 6 && f <= 6; ++r, ++f)
-            mask |= (1ULL << (r * 8 + f));
-        for (int r = rank - 1, f = file - 1; r >= 1 && f >= 1; --r, --f)
-            mask |= (1ULL << (r * 8 + f));
-
-        // Diagonal ↙↗ (exclude edges)
-        for (int r = rank + 1, f = file - 1; r <= 6 && f >= 1; ++r, --f)
-            mask |= (1ULL << (r * 8 + f));
-        for (int r = rank - 1, f = file + 1; r >= 1 && f <= 6; --r, ++f)
-            mask |= (1ULL << (r * 8 + f));
-
-        return mask;
-    }
-
-    // all possible blocker combinations for a mask
-    std::vector<U64> generateAllOccupancies(U64 mask) {
-        std::vector<U64> occupancies;
-        size_t numBits = static_cast<size_t>(__builtin_popcountll(mask));  // number of bits set in the mask
+            return mask;
+        }
+        constexpr U64 maskBishop(int sq) {
+            U64 mask = 0ULL;
+            int rank = sq / 8;
+            int file = sq % 8;
+
+            // Diagonal ↘↖ (exclude edges)
+            for (int r = rank + 1, f = file + 1; r <= 6 && f <= 6; ++r, ++f)
+                mask |= (1ULL << (r * 8 + f));
+            for (int r = rank - 1, f = file - 1; r >= 1 && f >= 1; --r, --f)
+                mask |= (1ULL << (r * 8 + f));
+
+            // Diagonal ↙↗ (exclude edges)
+            for (int r = rank + 1, f = file - 1; r <= 6 && f >= 1; ++r, --f)
+                mask |= (1ULL << (r * 8 + f));
+            for (int r = rank - 1, f = file + 1; r >= 1 && f <= 6; --r, ++f)
+                mask |= (1ULL << (r * 8 + f));
+
+            return mask;
+        }
 
-        std::vector<int> bitPositions;
-        for (int i = 0; i < 64; ++i) {
-            if ((mask >> i) & 1ULL) {
-                bitPositions.push_back(i);
-            }
+        constexpr int popcount(U64 bb) {
+            int n = 0;
+            for (; bb; bb &= bb - 1) n++;
+            return n;
         }
 
-        int permutations = 1 << numBits;  // 2^numBits
+        // generate attacks (bitboard) ... brute force
+        constexpr U64 rookAttacksOnTheFly(int sq, U64 blockers) {
+            U64 attacks = 0ULL;
+            int r = sq / 8, f = sq % 8;
 
-        for (int i = 0; i < permutations; ++i) {
-            U64 occupancy = 0ULL;
-            for (size_t j = 0; j < numBits; ++j) {
-                if ((i >> j) & 1) {
-                    occupancy |= (1ULL << bitPositions[j]);
-                }
+            // Right
+            for (int ff = f + 1; ff <= 7; ff++) {
+                int s = r * 8 + ff;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
+            // Left
+            for (int ff = f - 1; ff >= 0; ff--) {
+                int s = r * 8 + ff;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
+            // Up
+            for (int rr = r + 1; rr <= 7; rr++) {
+                int s = rr * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
             }
-            occupancies.push_back(occupancy);
+            // Down
+            for (int rr = r - 1; rr >= 0; rr--) {
+                int s = rr * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
+
+            return attacks;
         }
+        constexpr U64 bishopAttacksOnTheFly(int sq, U64 blockers) {
+            U64 attacks = 0ULL;
+            int rank = sq / 8;
+            int file = sq % 8;
+
+            // ↗ Northeast
+            for (int r = rank + 1, f = file + 1; r <= 7 && f <= 7; ++r, ++f) {
+                int s = r * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
 
-        return occupancies;
-    }
+            // ↘ Southeast
+            for (int r = rank - 1, f = file + 1; r >= 0 && f <= 7; --r, ++f) {
+                int s = r * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
 
+            // ↙ Southwest
+            for (int r = rank - 1, f = file - 1; r >= 0 && f >= 0; --r, --f) {
+                int s = r * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
 
-    // generate attacks (bitboard) ... brute force
-    U64 rookAttacksOnTheFly(int sq, U64 blockers) {
-        U64 attacks = 0ULL;
-        int r = sq / 8, f = sq % 8;
+            // ↖ Northwest
+            for (int r = rank + 1, f = file - 1; r <= 7 && f >= 0; ++r, --f) {
+                int s = r * 8 + f;
+                attacks |= (1ULL << s);
+                if (blockers & (1ULL << s)) break;
+            }
 
-        // Right
-        for (int ff = f + 1; ff <= 7; ff++) {
-            int s = r * 8 + ff;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
-        }
-        // Left
-        for (int ff = f - 1; ff >= 0; ff--) {
-            int s = r * 8 + ff;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
-        }
-        // Up
-        for (int rr = r + 1; rr <= 7; rr++) {
-            int s = rr * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
-        }
-        // Down
-        for (int rr = r - 1; rr >= 0; rr--) {
-            int s = rr * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
+            return attacks;
         }
 
-        return attacks;
-    }
-    U64 bishopAttacksOnTheFly(int sq, U64 blockers) {
-        U64 attacks = 0ULL;
-        int rank = sq / 8;
-        int file = sq % 8;
-
-        // ↗ Northeast
-        for (int r = rank + 1, f = file + 1; r <= 7 && f <= 7; ++r, ++f) {
-            int s = r * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
+        // walks every subset of the mask (carry-rippler) and fills the magic index for it
+        template <size_t N, typename MaskFn, typename AttackFn>
+        constexpr std::array<std::array<U64, N>, 64> makeAttackTable(const std::array<U64, 64>& magics, MaskFn mask, AttackFn attacks) {
+            std::array<std::array<U64, N>, 64> table{};
+            for (int sq = 0; sq < 64; ++sq) {
+                U64 m = mask(sq);
+                int shift = 64 - popcount(m);
+                U64 occ = 0ULL;
+                do {
+                    table[sq][(occ * magics[sq]) >> shift] = attacks(sq, occ);
+                    occ = (occ - m) & m;
+                } while (occ);
+            }
+            return table;
         }
 
-        // ↘ Southeast
-        for (int r = rank - 1, f = file + 1; r >= 0 && f <= 7; --r, ++f) {
-            int s = r * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
+        template <typename MaskFn>
+        constexpr std::array<U64, 64> makeMasks(MaskFn mask) {
+            std::array<U64, 64> masks{};
+            for (int sq = 0; sq < 64; ++sq) masks[sq] = mask(sq);
+            return masks;
         }
 
-        // ↙ Southwest
-        for (int r = rank - 1, f = file - 1; r >= 0 && f >= 0; --r, --f) {
-            int s = r * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
+        template <typename MaskFn>
+        constexpr std::array<int, 64> makeShifts(MaskFn mask) {
+            std::array<int, 64> shifts{};
+            for (int sq = 0; sq < 64; ++sq) shifts[sq] = 64 - popcount(mask(sq));
+            return shifts;
         }
+    }
 
-        // ↖ Northwest
-        for (int r = rank + 1, f = file - 1; r <= 7 && f >= 0; ++r, --f) {
-            int s = r * 8 + f;
-            attacks |= (1ULL << s);
-            if (blockers & (1ULL << s)) break;
-        }
+    constexpr std::array<U64, 64> rookMasks   = makeMasks(maskRook);
+    constexpr std::array<U64, 64> bishopMasks = makeMasks(maskBishop);
+    constexpr std::array<int, 64> rookShifts   = makeShifts(maskRook);
+    constexpr std::array<int, 64> bishopShifts = makeShifts(maskBishop);
 
-        return attacks;
-    }
+    // size must be 2^maxBits (2^12 rook, 2^9 bishop)
+    constexpr std::array<std::array<U64, 4096>, 64> rookAttackTable =
+        makeAttackTable<4096>(rookMagics, maskRook, rookAttacksOnTheFly);
+    constexpr std::array<std::array<U64, 512>, 64> bishopAttackTable =
+        makeAttackTable<512>(bishopMagics, maskBishop, bishopAttacksOnTheFly);
 
     // generate attacks ... magics
     U64 rookAttacks(int sq, U64 occ) {
@@ -5,469 +5,418 @@
 
 #include <moveGenerator.h>
 
+namespace {
+    constexpr U64 notAFile = ~Bits::file_masks[0];
+    constexpr U64 notHFile = ~Bits::file_masks[7];
+
+    // board shift in a pawn direction, with file wraps removed
+    template <int D>
+    constexpr U64 shift(U64 b) {
+        return D ==  8 ? b << 8
+             : D == -8 ? b >> 8
+             : D ==  7 ? (b << 7) & notHFile
+             : D ==  9 ? (b << 9) & notAFile
+             : D == -7 ? (b >> 7) & notAFile
+             : D == -9 ? (b >> 9) & notHFile
+             : 0ULL;
+    }
+}
+
 MoveGenerator::MoveGenerator(const Board& _board) {
     // load movegen at given state
-    //board = _board;
     updateBitboards(_board);
-    side = _board.is_white_move ? 0 : 1;
-    in_check = false; // board.is_in_check;
-    in_double_check = false; // gets updated during opponent gen moves
 }
 
-// look up kings last 
-//      have to generate opponenent attack map
-//          might not be that efficient for stuff like checks but it handles discoveries and everything
-//      then look up opponent king first
-
-// generate pins and legality
-// easier code might be to generate it on iteration and not in this bool stuff
-
 // fill in move info arrays
 int MoveGenerator::generateMoves(const Board& _board, bool _quiescence) {
     #ifdef DEV
         ScopedTimer timer(T_MOVEGEN);
     #endif
 
-    // load movegen at given state
+    // load movegen at given state (+ checks and pins)
     updateBitboards(_board);
     quiescence = _quiescence;
 
-    // gen opponent moves
-    // detect checks, pins, etc.
-    generatePawnAttacks(false); // false, false normally
-    generateKnightMoves(false);
-    generateSlidingMoves(false);
-    generateKingMoves(false);
-
-    //if (check_ray_mask) {in_check = true;}
-
-    if (in_double_check) { // cannot capture or block out of a double check
-        generateKingMoves(true);
+    // in check every evasion matters, quiescence otherwise only wants captures/promotions
+    if (in_check) {
+        if (side == 0) generateAll<white, EVASIONS>();
+        else           generateAll<black, EVASIONS>();
+    } else if (quiescence) {
+        if (side == 0) generateAll<white, CAPTURES>();
+        else           generateAll<black, CAPTURES>();
     } else {
-        // gen moves
-        // uses stored information from gen oppponent moves to determine legality
-        generatePawnPushes(true);
-        generatePawnAttacks(true);
-        generateKnightMoves(true);
-        generateSlidingMoves(true);
-        generateKingMoves(true);
+        if (side == 0) generateAll<white, ALL>();
+        else           generateAll<black, ALL>();
     }
 
-    return std::min(count, MAX_MOVES);
+    return count;
 }
 
-// accelerated return for quick check
-bool MoveGenerator::hasLegalMoves(const Board& _board) {
-    // load movegen at given state
-    //board = _board;
+template <GenType Type>
+int MoveGenerator::generate(const Board& _board) {
     updateBitboards(_board);
-    quiescence = false;
-
-    // gen opponent moves
-    // detect checks, pins, etc.
-    generatePawnAttacks(false); // false, false normally
-    generateKnightMoves(false);
-    generateSlidingMoves(false);
-    generateKingMoves(false);
-
-    //if (check_ray_mask) {in_check = true;}
-    if (in_double_check) { // cannot capture or block out of a double check
-        generateKingMoves(true);
-    } else {
-        // gen moves
-        // uses stored information from gen oppponent moves to determine legality
-        generatePawnPushes(true);
-        if (count > 0) {return true;}
-        generatePawnAttacks(true);
-        if (count > 0) {return true;}
-        generateKnightMoves(true);
-        if (count > 0) {return true;}
-        generateSlidingMoves(false);
-        if (count > 0) {return true;}
-        generateKingMoves(true);
-        if (count > 0) {return true;}
-    }
-
-    return false;
+    if (side == 0) generateAll<white, Type>();
+    else           generateAll<black, Type>();
+    return count;
 }
 
-// count number of pieces along pin_ray to determine if pinned 
-// if only piece then pinned, otherwise movement is legal (not necessarily good tho)
-bool MoveGenerator::isPinned(int square) {
-    if (!((pin_rays >> square) & 1)) return false;
-
-    // Full line through king and candidate in both directions
-    // filtered to single direction @ slider_sq
-    U64 full_line = PrecomputedMoveData::alignMasks[own_king_square][square];
-
-
-    // Enemy sliders along this full line
-    auto [dx, dy] = direction_map(own_king_square, square);
-    bool ortho = (dx == 0 || dy == 0);
-    U64 enemy_sliders = ortho ? (opp & (rooks | queens)) : (opp & (bishops | queens));
-    U64 sliders_on_line = full_line & enemy_sliders;
-    if (!sliders_on_line) return false;
-
-
-    // Pick slider along the ray: MSB if candidate < king, LSB if candidate > king
-    // pinning piece must be on 'more extreme' square idx than pinned_sq relative to king
-    int slider_sq = (square < own_king_square)
-                        ? getMSB(sliders_on_line & bitsBelow(square))
-                        : getLSB(sliders_on_line & bitsAbove(square));
+// legal move count without writing the move list
+int MoveGenerator::countLegalMoves(const Board& _board) {
+    updateBitboards(_board);
+    if (side == 0) generateAll<white, ALL, true>();
+    else           generateAll<black, ALL, true>();
+    return count;
+}
 
-    // square is not between king and enemy sliding piece
-    // solves UB of rayMask[king_sq][-1]
-    if (slider_sq < 0) {return false;}
+template int MoveGenerator::generate<ALL>(const Board&);
+template int MoveGenerator::generate<CAPTURES>(const Board&);
+template int MoveGenerator::generate<QUIETS>(const Board&);
+template int MoveGenerator::generate<EVASIONS>(const Board&);
 
-    // Count pieces between king and slider
-    U64 between_king_and_slider = PrecomputedMoveData::rayMasks[own_king_square][slider_sq] & (own | opp);
-    // remove end points (slider + king)
-    U64 between = between_king_and_slider & ~(1ULL << own_king_square | 1ULL << slider_sq);
+// stops at the first legal move; skips the opponent attack map entirely
+bool MoveGenerator::hasLegalMoves(const Board& _board) {
+    updateBitboards(_board, false);
+    return hasLegalMoves();
+}
 
-    // iff the only bit on between is the square we are checking, then it is pinned
-    // !!! slow i think !!!
-    return (between == (1ULL << square));
+// same query on the position loaded by the last generation/query
+bool MoveGenerator::hasLegalMoves() {
+    return (side == 0) ? anyLegalMove<white>() : anyLegalMove<black>();
 }
 
+template <int Us>
+bool MoveGenerator::anyLegalMove() {
+    constexpr int Up = (Us == white) ? 8 : -8;
+    constexpr U64 Rank3 = (Us == white) ? Bits::mask_rank_3 : Bits::mask_rank_6;
+    const U64 occ = own | opp;
+    const U64 empty = ~occ;
+
+    // king steps first: cheapest and usually available
+    // (castling never needs checking: a legal castle implies a legal king step)
+    U64 steps = PrecomputedMoveData::blankKingAttacks[own_king_square] & ~own;
+    const U64 occ_no_king = occ & ~(1ULL << own_king_square);
+    while (steps) {
+        int sq = getLSB(steps);
+        steps &= steps - 1;
+        if (!isAttacked(sq, occ_no_king)) return true;
+    }
+    if (in_double_check) return false;
 
-//need to make sure this doesnt result in a check 
-//regular pins (e.g. file and diag) should already be handled via pin_rays
-//but along rank, enpassant capture could result in check since both pawns are now gone
-// whoops: can be diag too 
-bool MoveGenerator::isEnpassantPinned(int start_square, int target_file) {
-    // occ before ep
-    enPassantMaskBlockers = (own|opp);
-
-    // perform ep
-    pop_bit(enPassantMaskBlockers, start_square); // dont re-init cause isnt relevant
-    // remove opp
-    if (side==0) pop_bit(enPassantMaskBlockers, 4*8 + target_file);
-    else pop_bit(enPassantMaskBlockers, 3*8 + target_file);
-    // occ after enpassant
-
-    U64 relevant_opp_ep_sliders = opp & (rooks | queens | bishops) & PrecomputedMoveData::alignMasks[start_square][own_king_square];
-    while (relevant_opp_ep_sliders) {
-        int opp_sq = getLSB(relevant_opp_ep_sliders);
-        pop_bit(relevant_opp_ep_sliders, opp_sq);
-
-        // not in ray
-        if (!(PrecomputedMoveData::alignMasks[own_king_square][opp_sq] & (1ULL << start_square))) {
-            continue;
-        }
+    U64 evasion = ~0ULL;
+    if (in_check) evasion = checkers | PrecomputedMoveData::between(own_king_square, getLSB(checkers));
+    const U64 target = ~own & evasion;
 
-        if ((rooks|queens) & (1ULL << opp_sq) && 
-            (Magics::rookAttacks(opp_sq, enPassantMaskBlockers) & (own & kings)))
-        {
-            return true;
-        }
+    // pieces
+    U64 bb = knights & own & ~pinned;
+    while (bb) {
+        if (PrecomputedMoveData::blankKnightAttacks[getLSB(bb)] & target) return true;
+        bb &= bb - 1;
+    }
+    bb = (bishops | rooks | queens) & own;
+    while (bb) {
+        int sq = getLSB(bb);
+        bb &= bb - 1;
+
+        U64 attacks = 0ULL;
+        if (bishops & (1ULL << sq))      attacks = Magics::bishopAttacks(sq, occ);
+        else if (rooks & (1ULL << sq))   attacks = Magics::rookAttacks(sq, occ);
+        else                             attacks = Magics::bishopAttacks(sq, occ) | Magics::rookAttacks(sq, occ);
+        if (pinned & (1ULL << sq))
+            attacks &= in_check ? 0ULL : PrecomputedMoveData::alignMasks[sq][own_king_square];
+        if (attacks & target) return true;
+    }
 
-        if ((bishops|queens) & (1ULL << opp_sq) && 
-            (Magics::bishopAttacks(opp_sq, enPassantMaskBlockers) & (own & kings)))
-        {
-            return true;
+    // pawns (promotions included - only existence matters)
+    const U64 free_pawns = pawns & own & ~pinned;
+    U64 push_one = shift<Up>(free_pawns) & empty;
+    U64 push_two = shift<Up>(push_one & Rank3) & empty;
+    if ((push_one | push_two) & evasion) return true;
+    U64 caps = ((Us == white) ? shift<7>(free_pawns) | shift<9>(free_pawns)
+                              : shift<-9>(free_pawns) | shift<-7>(free_pawns)) & opp & evasion;
+    if (caps) return true;
+
+    if (!in_check) {
+        U64 pinned_pawns = pawns & pinned;
+        while (pinned_pawns) {
+            int sq = getLSB(pinned_pawns);
+            pinned_pawns &= pinned_pawns - 1;
+
+            U64 line = PrecomputedMoveData::alignMasks[sq][own_king_square];
+            U64 p = 1ULL << sq;
+            U64 one = shift<Up>(p) & empty;
+            U64 moves_bb = one | (shift<Up>(one & Rank3) & empty)
+                         | (PrecomputedMoveData::fullPawnAttacks[sq][Us] & opp);
+            if (moves_bb & line) return true;
         }
     }
 
-    return false;
+    // en-passant (rare, full legality replay)
+    int saved_count = count;
+    count = 0;
+    generateEnPassant<Us, ALL, true>();
+    bool has_ep = count > 0;
+    count = saved_count;
+    return has_ep;
+}
+
+// is sq attacked by the opponent (given occupancy)
+bool MoveGenerator::isAttacked(int sq, U64 occ) const {
+    return ((PrecomputedMoveData::fullPawnAttacks[sq][side] & pawns)
+          | (PrecomputedMoveData::blankKnightAttacks[sq] & knights)
+          | (PrecomputedMoveData::blankKingAttacks[sq] & kings)
+          | (Magics::bishopAttacks(sq, occ) & (bishops | queens))
+          | (Magics::rookAttacks(sq, occ) & (rooks | queens))) & opp;
 }
 
 // -----------------------
-// ---- sliding moves ----
+// ----- attack maps -----
 // -----------------------
 
-// magic bitboards
-void MoveGenerator::generateSlidingMoves(bool ours) {
-    U64 occ = own | opp;
-    Move potential_move;
-
-    struct SlidingData { U64 bb; int type; };
-    std::vector<SlidingData> pieces;
+// all squares attacked by Color
+// no per-piece branching: pawns are set-wise shifts, the rest are table/magic lookups per bit
+template <int Color>
+U64 MoveGenerator::attackMap(const Board& board, U64 occ) {
+    const U64 pieces = board.colorBitboards[Color];
+    const U64 p = board.pieceBitboards[pawn] & pieces;
 
-    if (ours) {
-        if (rooks & own)   pieces.push_back({rooks & own, rook});
-        if (bishops & own) pieces.push_back({bishops & own, bishop});
-        if (queens & own)  pieces.push_back({queens & own, queen});
-    } else {
-        if (rooks & opp)   pieces.push_back({rooks & opp, rook});
-        if (bishops & opp) pieces.push_back({bishops & opp, bishop});
-        if (queens & opp)  pieces.push_back({queens & opp, queen});
-    }
+    U64 attacks = (Color == white) ? shift<7>(p) | shift<9>(p)
+                                   : shift<-9>(p) | shift<-7>(p);
 
-    for (auto &piece : pieces) {
-        while (piece.bb) {
-            int start_square = getLSB(piece.bb);
-            piece.bb &= piece.bb - 1;
+    U64 bb = board.pieceBitboards[knight] & pieces;
+    while (bb) { attacks |= PrecomputedMoveData::blankKnightAttacks[getLSB(bb)]; bb &= bb - 1; }
 
-            U64 potential_moves_bb = 0;
-            U64 attacks = 0;
+    bb = (board.pieceBitboards[bishop] | board.pieceBitboards[queen]) & pieces;
+    while (bb) { attacks |= Magics::bishopAttacks(getLSB(bb), occ); bb &= bb - 1; }
 
-            // get attack bitboard
-            if (piece.type == rook) attacks = Magics::rookAttacks(start_square, occ);
-            else if (piece.type == bishop) attacks = Magics::bishopAttacks(start_square, occ);
-            else attacks = Magics::rookAttacks(start_square, occ) | Magics::bishopAttacks(start_square, occ);
+    bb = (board.pieceBitboards[rook] | board.pieceBitboards[queen]) & pieces;
+    while (bb) { attacks |= Magics::rookAttacks(getLSB(bb), occ); bb &= bb - 1; }
 
-            updateAttackMapAndCheck(attacks, ours, start_square, piece.type);
+    attacks |= PrecomputedMoveData::blankKingAttacks[getLSB(board.pieceBitboards[king] & pieces)];
 
-            if (!ours) continue; // only need to update boards + check
-            
-            potential_moves_bb = attacks & ~own;
-
-            potential_moves_bb = limitPinnedMoves(start_square, potential_moves_bb);
-            potential_moves_bb = restrictCheckMoves(potential_moves_bb);
-
-            addMovesFromBitboard(start_square, potential_moves_bb);
-        }
-    }
+    return attacks;
 }
 
-// sliding bitboards
-/*
-U64 MoveGenerator::odiff(U64 occ, SMasks pMask) {
-    U64 lower, upper, ms1b, odiff_board;
-    lower = pMask.lower & occ;
-    upper = pMask.upper & occ;
-
-    ms1b = U64(0x8000000000000000) >> __builtin_clzll(lower | 1); // ms1b of lower (at least bit zero)
-    odiff_board = upper ^ (upper - ms1b);
-
-    return pMask.lineEx & odiff_board;
-}
+template U64 MoveGenerator::attackMap<white>(const Board&, U64);
+template U64 MoveGenerator::attackMap<black>(const Board&, U64);
 
-void MoveGenerator::generateSlidingMoves(bool ours) {
+// checkers, pins and the opponent attack map for the side to move
+// (king square, checkers and blockers come cached from the board's GameState)
+template <int Us>
+void MoveGenerator::updateCheckInfo(const Board& board, bool with_attack_map) {
+    constexpr int Them = 1 - Us;
+    const GameState& st = board.currentGameState;
 
-    auto processSlider = [&](U64 pieces, int num_dirs, auto attack_fn) {
-        while (pieces) {
-            int start_square = getLSB(pieces);
-            pieces &= pieces - 1;
+    own_king_square = st.kingSquare[Us];
 
-            for (int dir = 0; dir < num_dirs; dir++) {
-                const auto& atk = attack_fn(start_square, dir);
-                U64 potential = Bits::fullSet;
+    // king removed so it cannot step back along a checking ray
+    opponentAttackMap = with_attack_map ? attackMap<Them>(board, (own | opp) & ~(1ULL << own_king_square)) : 0ULL;
 
-                if (!ours) {
-                     U64 o_diff = odiff(own | opp, atk);
-                    potential &= o_diff & ~opp;
-                    opponentAttackMap |= o_diff;
+    checkers = st.checkers;
+    in_check = checkers != 0;
+    in_double_check = (checkers & (checkers - 1)) != 0;
 
-                    if (potential & (own & kings)) {
-                        in_double_check = in_check;
-                        check_ray_mask     |= PrecomputedMoveData::rayMasks[start_square][own_king_square];
-                        check_ray_mask_ext |= PrecomputedMoveData::alignMasks[start_square][own_king_square];
-                        in_check = true;
-                    }
-                    if (atk.lineEx & (own & kings))
-                        pin_rays |= PrecomputedMoveData::rayMasks[start_square][own_king_square] & ~(1ULL << own_king_square);
+    // own blockers are pinned (opponent blockers are discovered-check candidates for them)
+    pinned = st.blockersForKing[Us] & own;
+}
 
-                } else {
-                    potential &= odiff(own | opp, atk) & ~own;
-                    ownAttackMap |= potential;
+// -----------------------
+// ---- move generation ---
+// -----------------------
 
-                    potential = limitPinnedMoves(start_square, potential);
-                    potential = restrictCheckMoves(potential);
+template <int Us, GenType Type, bool CountOnly>
+void MoveGenerator::generateAll() {
+    // cannot capture or block out of a double check
+    if (!in_double_check) {
+        // squares that resolve the check (everything when not in check)
+        U64 evasion = ~0ULL;
+        if (in_check) {
+            int checker_sq = getLSB(checkers);
+            evasion = checkers | PrecomputedMoveData::between(own_king_square, checker_sq);
+        }
 
-                    addMovesFromBitboard(start_square, potential);
-                }
+        // pinned pieces can never resolve a check
+        U64 free_pawns = pawns & own & ~pinned;
+        generatePawnMoves<Us, Type, CountOnly>(free_pawns, evasion);
+        if (!in_check) {
+            U64 pinned_pawns = pawns & pinned;
+            while (pinned_pawns) {
+                int sq = getLSB(pinned_pawns);
+                pinned_pawns &= pinned_pawns - 1;
+                generatePawnMoves<Us, Type, CountOnly>(1ULL << sq, PrecomputedMoveData::alignMasks[sq][own_king_square]);
             }
         }
-    };
-
-    processSlider(rooks   & (ours ? own : opp), 2, [](int s, int d) -> const auto& { return PrecomputedMoveData::blankRookAttacks[s][d];   });
-    processSlider(bishops & (ours ? own : opp), 2, [](int s, int d) -> const auto& { return PrecomputedMoveData::blankBishopAttacks[s][d]; });
-    processSlider(queens  & (ours ? own : opp), 4, [](int s, int d) -> const auto& { return PrecomputedMoveData::blankQueenAttacks[s][d];  });
-}
-*/
-
-// ----------------------------
-// -- static move generation --
-// ----------------------------
-
-void MoveGenerator::generateKnightMoves(bool ours) {
-    U64 valid_knights = ours ? knights & own : knights & opp;
-    Move potential_move;
+        if constexpr (Type != QUIETS) generateEnPassant<Us, Type, CountOnly>();
 
-    while (valid_knights) {
-        int start_square = getLSB(valid_knights);
-        valid_knights &= valid_knights - 1;
+        const U64 occ = own | opp;
+        U64 target = (Type == CAPTURES) ? opp : (Type == QUIETS) ? ~occ : ~own;
+        target &= evasion;
 
-        // Start with the knight's attack mask
-        U64 potential_moves_bb = PrecomputedMoveData::blankKnightAttacks[start_square];
-        updateAttackMapAndCheck(potential_moves_bb, ours, start_square, knight);
-
-        if (!ours) continue; // only need to update boards + check
-
-        potential_moves_bb &= ~own;  // cannot capture own pieces
-
-        potential_moves_bb = limitPinnedMoves(start_square, potential_moves_bb);
-        potential_moves_bb = restrictCheckMoves(potential_moves_bb);
-
-        addMovesFromBitboard(start_square, potential_moves_bb);
+        generatePieceMoves<Us, knight, CountOnly>(target);
+        generatePieceMoves<Us, bishop, CountOnly>(target);
+        generatePieceMoves<Us, rook, CountOnly>(target);
+        generatePieceMoves<Us, queen, CountOnly>(target);
     }
-}
-
-
-void MoveGenerator::generatePawnPushes(bool ours) {
-    // never called for opponent
-    // doesnt have any "attacks"
-    if (!ours) {return;}
 
-    U64 valid_pawns = ours ? pawns & own : pawns & opp;
-    U64 potential_moves_bb;
-    Move potential_move;
-    int start_square;
-
-    bool on_starting_rank;
-    int one_step, two_step;
-
-    bool print_output = false;
-
-    while (valid_pawns) {
-        start_square = getLSB(valid_pawns);
-        valid_pawns &= valid_pawns - 1;
-
-        print_output = false;
-
-        // Start with the pawn's forward move mask
-        // do not update attacks as pawn pushes cannot be direct attacks
-        potential_moves_bb = PrecomputedMoveData::blankPawnMoves[start_square][side];
-        potential_moves_bb &= ~(own|opp);  // cannot push into pieces
+    generateKingMoves<Us, Type, CountOnly>();
+    generateCastles<Us, Type, CountOnly>();
+}
 
-        // Remove double push if blocked
-        on_starting_rank = (side == 0) ? (((1ULL << start_square) & Bits::mask_rank_2) != 0) 
-                                        : (((1ULL << start_square) & Bits::mask_rank_7) != 0);
-        one_step = start_square + ((side == 0) ? 8 : -8);
-        two_step = start_square + ((side == 0) ? 16 : -16);
-        if (on_starting_rank && !get_bit(potential_moves_bb, one_step)) {
-            potential_moves_bb &= ~(1ULL << two_step);
+template <int Us, GenType Type, bool CountOnly>
+void MoveGenerator::generatePawnMoves(U64 pawns_bb, U64 target) {
+    constexpr int Up        = (Us == white) ? 8 : -8;
+    constexpr int UpLeft    = (Us == white) ? 7 : -9;
+    constexpr int UpRight   = (Us == white) ? 9 : -7;
+    constexpr U64 Rank7     = (Us == white) ? Bits::mask_rank_7 : Bits::mask_rank_2;
+    constexpr U64 Rank3     = (Us == white) ? Bits::mask_rank_3 : Bits::mask_rank_6;
+
+    const U64 empty = ~(own | opp);
+    const U64 promo_pawns = pawns_bb & Rank7;
+    const U64 rest = pawns_bb & ~Rank7;
+
+    // single + double pushes
+    if constexpr (Type != CAPTURES) {
+        U64 push_one = shift<Up>(rest) & empty;
+        U64 push_two = shift<Up>(push_one & Rank3) & empty;
+        push_one &= target;
+        push_two &= target;
+
+        if constexpr (CountOnly) {
+            count += countBits(push_one) + countBits(push_two);
+            push_one = push_two = 0ULL;
+        }
+        while (push_one) {
+            int to = getLSB(push_one); push_one &= push_one - 1;
+            moves[count++] = Move(to - Up, to);
+        }
+        while (push_two) {
+            int to = getLSB(push_two); push_two &= push_two - 1;
+            moves[count++] = Move(to - 2 * Up, to, Move::pawnTwoUpFlag);
         }
+    }
 
-        potential_moves_bb = limitPinnedMoves(start_square, potential_moves_bb);
-        potential_moves_bb = restrictCheckMoves(potential_moves_bb);
+    if constexpr (Type != QUIETS) {
+        // captures
+        U64 cap_left  = shift<UpLeft>(rest)  & opp & target;
+        U64 cap_right = shift<UpRight>(rest) & opp & target;
+        if constexpr (CountOnly) {
+            count += countBits(cap_left) + countBits(cap_right);
+            cap_left = cap_right = 0ULL;
+        }
+        while (cap_left) {
+            int to = getLSB(cap_left); cap_left &= cap_left - 1;
+            moves[count++] = Move(to - UpLeft, to);
+        }
+        while (cap_right) {
+            int to = getLSB(cap_right); cap_right &= cap_right - 1;
+            moves[count++] = Move(to - UpRight, to);
+        }
 
-        forEachBit(potential_moves_bb, [&](int target_square) {
-            if (target_square == two_step) {
-                Move m(start_square, target_square, Move::pawnTwoUpFlag);
-                if (shouldAddMove(m)) moves[count++] = m;
+        // promotions (quiet promotions count as tactical)
+        if (promo_pawns) {
+            U64 promo_push  = shift<Up>(promo_pawns)      & empty & target;
+            U64 promo_left  = shift<UpLeft>(promo_pawns)  & opp & target;
+            U64 promo_right = shift<UpRight>(promo_pawns) & opp & target;
+            if constexpr (CountOnly) {
+                count += 4 * (countBits(promo_push) + countBits(promo_left) + countBits(promo_right));
+                return;
             }
-            else if (isPromotionPawn(start_square)) {
-                generatePromotions(start_square, target_square);
-            }
-            else {
-                Move m(start_square, target_square);
-                if (shouldAddMove(m)) moves[count++] = m;
-            }
-        });
+            while (promo_left)  { int to = getLSB(promo_left);  promo_left  &= promo_left - 1;  addPromotions(to - UpLeft, to); }
+            while (promo_right) { int to = getLSB(promo_right); promo_right &= promo_right - 1; addPromotions(to - UpRight, to); }
+            while (promo_push)  { int to = getLSB(promo_push);  promo_push  &= promo_push - 1;  addPromotions(to - Up, to); }
+        }
     }
 }
 
-void MoveGenerator::generatePawnAttacks(bool ours) {
-    U64 valid_pawns = ours ? pawns & own : pawns & opp;
-    Move potential_move;
-
-    while (valid_pawns) {
-        int start_square = getLSB(valid_pawns);
-        valid_pawns &= valid_pawns - 1;
-
-        // Start with full attack mask for opponent attack map
-        U64 potential_moves_bb = PrecomputedMoveData::fullPawnAttacks[start_square][ours ? side : 1-side];
-        updateAttackMapAndCheck(potential_moves_bb, ours, start_square, pawn);
-
-        if (!ours) continue; // only need to update boards + check
+// en-passant legality is checked by replaying the capture on the occupancy:
+// both pawns leave the rank, so rank/diagonal discoveries are covered
+template <int Us, GenType Type, bool CountOnly>
+void MoveGenerator::generateEnPassant() {
+    if (curr_gamestate.enPassantFile < 0) return;
+
+    constexpr int Them = 1 - Us;
+    const int ep_square = ((Us == white) ? 5 * 8 : 2 * 8) + curr_gamestate.enPassantFile;
+    const int captured_sq = ep_square + ((Us == white) ? -8 : 8);
+
+    U64 capturers = PrecomputedMoveData::fullPawnAttacks[ep_square][Them] & pawns & own;
+    while (capturers) {
+        int from = getLSB(capturers);
+        capturers &= capturers - 1;
+
+        U64 occ = ((own | opp) ^ (1ULL << from) ^ (1ULL << captured_sq)) | (1ULL << ep_square);
+        U64 remaining_opp = opp & ~(1ULL << captured_sq);
+        U64 attackers = (Magics::rookAttacks(own_king_square, occ) & (rooks | queens))
+                      | (Magics::bishopAttacks(own_king_square, occ) & (bishops | queens))
+                      | (PrecomputedMoveData::blankKnightAttacks[own_king_square] & knights)
+                      | (PrecomputedMoveData::fullPawnAttacks[own_king_square][Us] & pawns);
+        if (attackers & remaining_opp) continue;
+
+        if constexpr (CountOnly) count++;
+        else moves[count++] = Move(from, ep_square, Move::enPassantCaptureFlag);
+    }
+}
 
-        potential_moves_bb &= opp;
+template <int Us, int Pt, bool CountOnly>
+void MoveGenerator::generatePieceMoves(U64 target) {
+    const U64 occ = own | opp;
+    U64 pieces = own & ((Pt == knight) ? knights : (Pt == bishop) ? bishops : (Pt == rook) ? rooks : queens);
 
-        potential_moves_bb = limitPinnedMoves(start_square, potential_moves_bb);
-        potential_moves_bb = restrictCheckMoves(potential_moves_bb);
+    // pinned knights can never move
+    if constexpr (Pt == knight) pieces &= ~pinned;
 
-        // Handle en passant
-        if (curr_gamestate.enPassantFile > -1) {
-            int ep_square = (!side ? 5*8 : 2*8) + curr_gamestate.enPassantFile;   // destination
-            int captured_pawn_sq = (!side ? 4*8 : 3*8) + curr_gamestate.enPassantFile;
+    while (pieces) {
+        int start_square = getLSB(pieces);
+        pieces &= pieces - 1;
 
-            bool can_capture_ep = PrecomputedMoveData::fullPawnAttacks[start_square][side] & (1ULL << ep_square);
-            bool ep_safe = !isEnpassantPinned(start_square, curr_gamestate.enPassantFile);
-            bool ep_legal_in_check = !in_check || (check_ray_mask & (1ULL << captured_pawn_sq));
+        U64 attacks = (Pt == knight) ? PrecomputedMoveData::blankKnightAttacks[start_square]
+                    : (Pt == bishop) ? Magics::bishopAttacks(start_square, occ)
+                    : (Pt == rook)   ? Magics::rookAttacks(start_square, occ)
+                    : Magics::bishopAttacks(start_square, occ) | Magics::rookAttacks(start_square, occ);
+        attacks &= target;
 
-            if (can_capture_ep && ep_safe && ep_legal_in_check) {
-                potential_moves_bb |= 1ULL << ep_square;
-            }
+        if constexpr (Pt != knight) {
+            if (pinned & (1ULL << start_square))
+                attacks &= PrecomputedMoveData::alignMasks[start_square][own_king_square];
         }
 
-        // Add moves
-        // must write out full function (addMoves only accepts 1 flag)
-        forEachBit(potential_moves_bb, [&](int target_square) {
-            if (isPromotionPawn(start_square)) {
-                generatePromotions(start_square, target_square);
-            } else if ((target_square % 8) == curr_gamestate.enPassantFile &&
-                        ((side == 0 && target_square / 8 == 5) || (side == 1 && target_square / 8 == 2))) {
-                Move m(start_square, target_square, Move::enPassantCaptureFlag);
-                if (shouldAddMove(m)) moves[count++] = m;
-            } else {
-                Move m(start_square, target_square);
-                if (shouldAddMove(m)) moves[count++] = m;
-            }
-        });
+        if constexpr (CountOnly) count += countBits(attacks);
+        else addMovesFromBitboard(start_square, attacks);
     }
 }
 
+template <int Us, GenType Type, bool CountOnly>
+void MoveGenerator::generateKingMoves() {
+    U64 targets = PrecomputedMoveData::blankKingAttacks[own_king_square] & ~own & ~opponentAttackMap;
+    if constexpr (Type == CAPTURES) targets &= opp;
+    if constexpr (Type == QUIETS)   targets &= ~opp;
 
-void MoveGenerator::generatePromotions(int start_square, int target_square) { 
-    int move_flags[4] = {Move::promoteToQueenFlag, Move::promoteToKnightFlag, Move::promoteToRookFlag, Move::promoteToBishopFlag};
-    Move potential_move;
-
-    for (int flag : move_flags) {
-        potential_move = Move(start_square, target_square, flag);
-        if (shouldAddMove(potential_move)) 
-            moves[count++] = potential_move;
-    }
+    if constexpr (CountOnly) count += countBits(targets);
+    else addMovesFromBitboard(own_king_square, targets);
 }
 
+template <int Us, GenType Type, bool CountOnly>
+void MoveGenerator::generateCastles() {
+    if constexpr (Type == CAPTURES || Type == EVASIONS) return;
+    if (in_check) return;
 
-void MoveGenerator::generateKingMoves(bool ours) {
-    int king_square = ours ? own_king_square : sqidx(kings & opp);
-    Move potential_move;
-    U64 potential_moves_bb = PrecomputedMoveData::blankKingAttacks[king_square];
-
-    // Update attack maps
-    updateAttackMapAndCheck(potential_moves_bb, ours, king_square, king);
-    if (!ours) return;
-
-    // Remove friendly-occupied squares
-    potential_moves_bb &= ~own;
-
-    // Prevent king from moving into attack
-    potential_moves_bb &= ~opponentAttackMap;
-
-    // Limit moves if in check
-    if (in_check) {
-        //check_ray_mask_ext |= check_ray_mask;
-        potential_moves_bb &= (~check_ray_mask_ext) | (opp & check_ray_mask);
-    }
-
-    addMovesFromBitboard(king_square, potential_moves_bb);
+    const U64 occ = own | opp;
+    const U64 castle_blockers = opponentAttackMap | occ;
 
-    // Castling
-    if (ours && !in_check) {
-        U64 castle_blockers = opponentAttackMap | own | opp;
-
-        // Kingside
-        if (curr_gamestate.HasKingsideCastleRight(side == 0)) {
-            U64 mask = (side == 0) ? Bits::whiteKingsideMask : Bits::blackKingsideMask;
-            if (!(mask & castle_blockers)) {
-                int target = (side == 0) ? g1 : g8;
-                Move m(king_square, target, Move::castleFlag);
-                if (shouldAddMove(m)) moves[count++] = m;
-            }
+    // Kingside
+    if (curr_gamestate.HasKingsideCastleRight(Us == white)) {
+        constexpr U64 mask = (Us == white) ? Bits::whiteKingsideMask : Bits::blackKingsideMask;
+        if (!(mask & castle_blockers)) {
+            if constexpr (CountOnly) count++;
+            else moves[count++] = Move(own_king_square, (Us == white) ? g1 : g8, Move::castleFlag);
         }
+    }
 
-        // Queenside
-        if (curr_gamestate.HasQueensideCastleRight(side == 0)) {
-            U64 mask = (side == 0) ? Bits::whiteQueensideMask : Bits::blackQueensideMask;
-            U64 mask_ext = (side == 0) ? Bits::whiteQueensideMaskExt : Bits::blackQueensideMaskExt;
-            if (!(mask & castle_blockers) && !((own | opp) & mask_ext)) {
-                int target = (side == 0) ? c1 : c8;
-                Move m(king_square, target, Move::castleFlag);
-                if (shouldAddMove(m)) moves[count++] = m;
-            }
+    // Queenside
+    if (curr_gamestate.HasQueensideCastleRight(Us == white)) {
+        constexpr U64 mask = (Us == white) ? Bits::whiteQueensideMask : Bits::blackQueensideMask;
+        constexpr U64 mask_ext = (Us == white) ? Bits::whiteQueensideMaskExt : Bits::blackQueensideMaskExt;
+        if (!(mask & castle_blockers) && !(occ & mask_ext)) {
+            if constexpr (CountOnly) count++;
+            else moves[count++] = Move(own_king_square, (Us == white) ? c1 : c8, Move::castleFlag);
         }
     }
 }
@@ -480,8 +429,7 @@ bool MoveGenerator::isCheck(const Move move) {
     U64 opp_king = opp & kings;
     U64 new_occ = ((own | opp) & ~(1ULL << start_square)) | (1ULL << target_square);
     U64 new_own = ((own) & ~(1ULL << start_square)) | (1ULL << target_square);
-    U64 discovery_ray = PrecomputedMoveData::rayMasks[start_square][sqidx(opp_king)]; // includes king
-    bool is_direct_check;
+    bool is_direct_check = false;
 
     // get moved piece (could be replaced with board pointer functions)
     if (pawns & (1ULL << start_square)) piece = pawn;
@@ -494,10 +442,15 @@ bool MoveGenerator::isCheck(const Move move) {
     // direct checks
     switch (piece) {
         case king:
-            is_direct_check = false;
+            // castling: the rook lands next to the king
+            if (move.MoveFlag() == Move::castleFlag) {
+                int rook_to = target_square > start_square ? target_square - 1 : target_square + 1;
+                is_direct_check = (Magics::rookAttacks(rook_to, new_occ) & opp_king);
+            }
             break;
         case pawn:
-            is_direct_check = (PrecomputedMoveData::fullPawnAttacks[target_square][side] & opp_king);
+            // a promoting pawn is checked as its new piece below
+            is_direct_check = !move.IsPromotion() && (PrecomputedMoveData::fullPawnAttacks[target_square][side] & opp_king);
             break;
         case knight:
             is_direct_check = (PrecomputedMoveData::blankKnightAttacks[target_square] & opp_king);
@@ -515,20 +468,26 @@ bool MoveGenerator::isCheck(const Move move) {
     if (is_direct_check) return true;
 
     // discovered checks
-    
+
     // enpassant capture discovery check (rook + king along rank as both pawns)
     if (move.MoveFlag() == Move::enPassantCaptureFlag) {
         // remove ep captured pawn
         new_occ &= ~(1ULL << (target_square + (!side ? -8 : 8)));
     }
 
-    U64 blockers = new_occ & discovery_ray; // includes discovery_sliders
-    U64 discovery_sliders = (rooks | bishops | queens) & new_own & discovery_ray;
-    
-    blockers &= ~discovery_sliders; // only non-own sliding pieces along the ray
-    if (blockers == opp_king)
+    // moving one of our blockers off its line to their king
+    int opp_king_sq = curr_gamestate.kingSquare[1 - side];
+    if ((curr_gamestate.blockersForKing[1 - side] & own & (1ULL << start_square))
+        && !(PrecomputedMoveData::alignMasks[start_square][opp_king_sq] & (1ULL << target_square)))
         return true;
 
+    // ep removes two pawns from the rank at once - not covered by single blockers
+    if (move.MoveFlag() == Move::enPassantCaptureFlag) {
+        if ((Magics::rookAttacks(opp_king_sq, new_occ) & (rooks | queens) & new_own)
+            || (Magics::bishopAttacks(opp_king_sq, new_occ) & (bishops | queens) & new_own))
+            return true;
+    }
+
     // promotions (direct checks from new promotion piece)
     if (move.IsPromotion()) {
         switch (move.PromotionPieceType()) {
@@ -550,12 +509,9 @@ bool MoveGenerator::isCheck(const Move move) {
     return false;
 }
 
-void MoveGenerator::updateBitboards(const Board& _board) {
-    //board = _board;
+void MoveGenerator::updateBitboards(const Board& _board, bool with_attack_map) {
     curr_gamestate = _board.currentGameState;
     side = _board.is_white_move ? 0 : 1;
-    in_check = false; //board.is_in_check;
-    in_double_check = false; // both get updated during gen opponent moves
 
     own = _board.colorBitboards[side];
     opp = _board.colorBitboards[1-side];
@@ -566,78 +522,23 @@ void MoveGenerator::updateBitboards(const Board& _board) {
     queens = _board.pieceBitboards[queen];
     kings = _board.pieceBitboards[king];
 
-    check_ray_mask = 0ULL;
-    check_ray_mask_ext = 0ULL;
-    pin_rays = 0ULL;
-    opponentAttackMap = ownAttackMap = 0ULL;
-    own_king_square = sqidx(own&kings);
+    if (side == 0) updateCheckInfo<white>(_board, with_attack_map);
+    else           updateCheckInfo<black>(_board, with_attack_map);
 
     count = 0;
 }
 
-U64 MoveGenerator::limitPinnedMoves(int square, U64 moves_bb) {
-    if (isPinned(square)) {
-        moves_bb &= PrecomputedMoveData::alignMasks[square][own_king_square];
-    }
-    return moves_bb;
-}
-
-U64 MoveGenerator::restrictCheckMoves(U64 moves_bb) {
-    if (in_check) moves_bb &= check_ray_mask;
-    return moves_bb;
-}
-
 void MoveGenerator::addMovesFromBitboard(int start_square, U64 moves_bb, int flag) {
-    forEachBit(moves_bb, [&](int target_square){
-        Move m(start_square, target_square, flag);
-        if (shouldAddMove(m)) moves[count++] = m;
-    });
-}
-
-bool MoveGenerator::isPromotionPawn(int square) {
-    return (!side && get_bit(Bits::mask_rank_7, square)) || 
-           (side && get_bit(Bits::mask_rank_2, square));
-}
-
-void MoveGenerator::updateAttackMapAndCheck(U64 attacks_bb, bool ours, int start_square, int piece_type) {
-    if (ours) {
-        ownAttackMap |= attacks_bb;
-    } else {
-        opponentAttackMap |= attacks_bb;
-
-        // skewers/pinned pieces
-        // a->b  inclusive
-        if (piece_type == bishop || piece_type == rook || piece_type == queen) {
-            pin_rays |= PrecomputedMoveData::rayMasks[start_square][sqidx(own&kings)];
-        }
-
-
-        // checks
-        if (attacks_bb & (own & kings)) {
-            in_double_check = in_check;
-            in_check = true;
-
-            if (piece_type == pawn || piece_type == knight) {
-                // Only the attacking square matters
-                check_ray_mask |= 1ULL << start_square;
-            } else if (piece_type > -1 && piece_type < king) {
-                // sliding piece
-                check_ray_mask |= PrecomputedMoveData::rayMasks[start_square][own_king_square];
-                check_ray_mask_ext |= PrecomputedMoveData::alignMasks[start_square][own_king_square];
-            } else {
-                // king attacking king? should not happen
-            }
-        }
+    while (moves_bb) {
+        int target_square = getLSB(moves_bb);
+        moves_bb &= moves_bb - 1;
+        moves[count++] = Move(start_square, target_square, flag);
     }
 }
 
-
-
-
-bool MoveGenerator::shouldAddMove(const Move& move) const {
-    if (in_check) return true;              // all moves matter in check
-    if (!quiescence) return true;           // in normal search, include everything
-    if (move.IsPromotion()) return true;    // promotions are always interesting
-    if (opp & (1ULL << move.TargetSquare())) return true; // captures
-    return false;                           // otherwise, ignore in quiescence
-}
\ No newline at end of file
+void MoveGenerator::addPromotions(int start_square, int target_square) {
+    moves[count++] = Move(start_square, target_square, Move::promoteToQueenFlag);
+    moves[count++] = Move(start_square, target_square, Move::promoteToKnightFlag);
+    moves[count++] = Move(start_square, target_square, Move::promoteToRookFlag);
+    moves[count++] = Move(start_square, target_square, Move::promoteToBishopFlag);
+}
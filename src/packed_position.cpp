@@ -0,0 +1,42 @@
+// Packed position files
+// flat streams of 32-byte records (layout in packed_position.h)
+
+#include <packed_position.h>
+#include <board.h>
+
+// -------------------------------
+// Writer
+// -------------------------------
+
+PackedPositionWriter::PackedPositionWriter(const fs::path& path, bool append)
+    : out(path, std::ios::binary | (append ? std::ios::app : std::ios::trunc)) {}
+
+void PackedPositionWriter::write(const PackedPosition& packed) {
+    out.write(reinterpret_cast<const char*>(packed.bytes), PackedPosition::SIZE);
+    written++;
+}
+
+void PackedPositionWriter::write(const Board& board) {
+    write(board.pack());
+}
+
+// -------------------------------
+// Reader
+// -------------------------------
+
+PackedPositionReader::PackedPositionReader(const fs::path& path) : in(path, std::ios::binary) {}
+
+bool PackedPositionReader::next(PackedPosition& packed) {
+    if (!in.read(reinterpret_cast<char*>(packed.bytes), PackedPosition::SIZE)) return false;
+    records++;
+    return true;
+}
+
+bool PackedPositionReader::next(Board& board) {
+    PackedPosition packed;
+    while (next(packed)) {
+        if (board.unpack(packed)) return true;
+        malformed++;
+    }
+    return false;
+}
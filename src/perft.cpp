@@ -0,0 +1,227 @@
+// Perft
+// fast move path enumeration for movegen regression + throughput benchmarking
+
+#include <perft.h>
+#include <moveGenerator.h>
+#include <thread>
+#include <chrono>
+#include <logging.h>
+#include <session.h>
+#include <fstream>
+#include <cstdio>
+
+// -------------------------------
+// Perft hash table
+// -------------------------------
+
+PerftTable::PerftTable(size_t mbSize) {
+    size_t entries = (mbSize * 1024 * 1024) / sizeof(Entry);
+    size_t pow2 = 1;
+    while (pow2 * 2 <= entries) pow2 *= 2;
+
+    table = std::make_unique<Entry[]>(pow2);
+    mask = pow2 - 1;
+}
+
+bool PerftTable::probe(U64 key, int depth, uint64_t& nodes) const {
+    const Entry& e = table[key & mask];
+    uint64_t data = e.data.load(std::memory_order_relaxed);
+    uint64_t check = e.check.load(std::memory_order_relaxed);
+
+    if ((check ^ data) != key || static_cast<int>(data & 0xFF) != depth) return false;
+
+    nodes = data >> 8;
+    return true;
+}
+
+void PerftTable::store(U64 key, int depth, uint64_t nodes) {
+    Entry& e = table[key & mask];
+    uint64_t data = (nodes << 8) | static_cast<uint64_t>(depth);
+
+    e.check.store(key ^ data, std::memory_order_relaxed);
+    e.data.store(data, std::memory_order_relaxed);
+}
+
+void PerftTable::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        table[i].check.store(0, std::memory_order_relaxed);
+        table[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+// -------------------------------
+// Recursive counting
+// -------------------------------
+
+namespace {
+    uint64_t perftNode(Board& board, MoveGenerator& movegen, PerftTable* table, int depth) {
+        // bulk count: the legal move count is the leaf count
+        if (depth == 1) return static_cast<uint64_t>(movegen.countLegalMoves(board));
+
+        uint64_t nodes = 0;
+        if (table && table->probe(board.zobrist_hash, depth, nodes)) return nodes;
+
+        Move moves[MAX_MOVES];
+        int count = movegen.generateMoves(board, false);
+        std::copy_n(movegen.moves, count, moves);
+
+        for (int i = 0; i < count; i++) {
+            board.MakeMove(moves[i]);
+            nodes += perftNode(board, movegen, table, depth - 1);
+            board.UnmakeMove(moves[i]);
+        }
+
+        if (table) table->store(board.zobrist_hash, depth, nodes);
+        return nodes;
+    }
+}
+
+// -------------------------------
+// Root split
+// -------------------------------
+
+PerftResult runPerft(const Board& root, int depth, int threads, size_t hash_mb) {
+    std::unique_ptr<PerftTable> table;
+    if (hash_mb > 0 && depth > 2) table = std::make_unique<PerftTable>(hash_mb);
+    return runPerft(root, depth, threads, table.get());
+}
+
+PerftResult runPerft(const Board& root, int depth, int threads, PerftTable* table) {
+    auto start = std::chrono::steady_clock::now();
+    PerftResult result;
+
+    if (depth <= 0) {
+        result.nodes = 1;
+        return result;
+    }
+
+    // Boards carry their full history stacks: heap, not the (worker) stack
+    auto root_board = std::make_unique<Board>(root);
+    MoveGenerator root_gen(*root_board);
+    int count = root_gen.generateMoves(*root_board, false);
+
+    std::vector<Move> root_moves(root_gen.moves, root_gen.moves + count);
+    std::vector<uint64_t> root_nodes(static_cast<size_t>(count), 0);
+
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::min(threads, std::max(count, 1));
+
+    // each worker pulls the next unclaimed root move
+    std::atomic<int> next{0};
+    auto worker = [&]() {
+        auto board = std::make_unique<Board>(root);
+        MoveGenerator movegen(*board);
+
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            size_t idx = static_cast<size_t>(i);
+            if (depth == 1) { root_nodes[idx] = 1; continue; }
+
+            board->MakeMove(root_moves[idx]);
+            root_nodes[idx] = perftNode(*board, movegen, table, depth - 1);
+            board->UnmakeMove(root_moves[idx]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    for (int i = 0; i < count; i++) {
+        result.nodes += root_nodes[static_cast<size_t>(i)];
+        result.divide.emplace_back(root_moves[static_cast<size_t>(i)], root_nodes[static_cast<size_t>(i)]);
+    }
+
+    result.time_ms = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return result;
+}
+
+// -------------------------------
+// Suite logging
+// -------------------------------
+
+namespace {
+    std::ofstream& perftLog() {
+        static std::ofstream out(Logging::log_file_name("perft.jsonl"), std::ios::app);
+        return out;
+    }
+
+    // JSON string body: quotes, backslashes and control characters escaped
+    std::string jsonEscape(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    void writeSettings(std::ofstream& out, const PerftSuiteSettings& settings) {
+        out << "\"threads\":" << settings.threads << ",";
+        out << "\"hash_mb\":" << settings.hash_mb << ",";
+    }
+}
+
+void logPerftEntry(const PerftSuiteEntry& entry, const PerftSuiteSettings& settings) {
+    std::ofstream& out = perftLog();
+    if (!out.is_open()) return;
+
+    uint64_t nps = entry.time_ms ? entry.nodes * 1000 / entry.time_ms : 0;
+
+    out << "{";
+    out << "\"engine_id\":\"" << ENGINE_ID << "\",";
+    out << "\"instance_id\":" << instanceID() << ",";
+    out << "\"type\":\"perft\",";
+    out << "\"session\":" << currentSession() << ",";
+    out << "\"fen\":\"" << jsonEscape(entry.fen) << "\",";
+    writeSettings(out, settings);
+    out << "\"pass\":" << (entry.pass ? "true" : "false") << ",";
+    out << "\"nodes\":" << entry.nodes << ",";
+    out << "\"time_ms\":" << entry.time_ms << ",";
+    out << "\"nps\":" << nps << ",";
+    out << "\"depths\":[";
+    for (size_t i = 0; i < entry.depths.size(); i++) {
+        const auto& d = entry.depths[i];
+        if (i) out << ",";
+        out << "{\"depth\":" << d.depth
+            << ",\"expected\":" << d.expected
+            << ",\"nodes\":" << d.nodes
+            << ",\"time_ms\":" << d.time_ms
+            << ",\"pass\":" << (d.pass ? "true" : "false") << "}";
+    }
+    out << "]}\n";
+    out.flush();
+}
+
+void logPerftSummary(const std::string& file, const PerftSuiteSettings& settings, int positions, int passed, uint64_t nodes, uint64_t time_ms) {
+    std::ofstream& out = perftLog();
+    if (!out.is_open()) return;
+
+    uint64_t nps = time_ms ? nodes * 1000 / time_ms : 0;
+
+    out << "{";
+    out << "\"engine_id\":\"" << ENGINE_ID << "\",";
+    out << "\"instance_id\":" << instanceID() << ",";
+    out << "\"type\":\"perft_suite\",";
+    out << "\"session\":" << currentSession() << ",";
+    out << "\"file\":\"" << jsonEscape(file) << "\",";
+    out << "\"max_depth\":" << settings.max_depth << ",";
+    writeSettings(out, settings);
+    out << "\"positions\":" << positions << ",";
+    out << "\"passed\":" << passed << ",";
+    out << "\"nodes\":" << nodes << ",";
+    out << "\"time_ms\":" << time_ms << ",";
+    out << "\"nps\":" << nps;
+    out << "}\n";
+    out.flush();
+}
@@ -9,12 +9,6 @@
 // Construction / small helpers
 // ============================================================================
 
-void Searcher::updatePV(std::vector<Move>& pv, const Move& move, const std::vector<Move>& childPV) {
-    pv.clear();
-    pv.push_back(move);
-    pv.insert(pv.end(), childPV.begin(), childPV.end());
-}
-
 // leaf node pruning
 bool Searcher::shouldPrune(Move& move, int standPat, int alpha, int search_depth, int ply) {
     const int captured = board.getCapturedPiece(move.TargetSquare());
@@ -65,6 +59,32 @@ inline int Searcher::get_node_count(Move m) const {
     return node_count_table[m.Value()];
 }
 
+double Searcher::timeScale(const SearchResult& res, int stability, int score_drop) const {
+    // best move stable for several iterations -> spend less, just flipped -> spend more
+    double scale = params.TM_STABILITY_SCALE[std::min(stability, 4)];
+
+    // share of the iteration's nodes spent on the best move: high = the alternatives were refuted quickly
+    uint64_t total = 0, best = 0;
+    for (int i = 0; i < res.root_count; ++i) {
+        total += res.root_moves[i].nodes;
+        if (Move::SameMove(res.root_moves[i].move, res.bestMove)) best = res.root_moves[i].nodes;
+    }
+    if (total > 0) {
+        double fraction = static_cast<double>(best) / static_cast<double>(total);
+        scale *= (params.TM_NODE_BASE - fraction) * params.TM_NODE_MULT;
+    }
+
+    // score falling / aspiration failing low -> the position is harder than it looked
+    scale *= 1.0 + static_cast<double>(std::clamp(score_drop, 0, params.TM_SCORE_DROP_CAP)) * params.TM_SCORE_DROP_SCALE
+                 + static_cast<double>(std::min(res.fail_lows, 3)) * params.TM_FAIL_LOW_SCALE;
+    return scale;
+}
+
+void Searcher::clearHeuristics() {
+    std::fill(std::begin(search_stack), std::end(search_stack), SearchStackEntry{});
+    std::fill(&historyHeuristic[0][0], &historyHeuristic[0][0] + 12 * 64, 0);
+}
+
 
 // ============================================================================
 // MOVE ORDERING
@@ -94,12 +114,13 @@ int Searcher::rootMoveScore(const Move& move, const Move& ttMove, const Move& pv
 }
 
 int Searcher::moveScore(const Move& move, const Board& boardRef,
-                        int ply, const Move& ttMove, const std::vector<Move>& previousPV) {
+                        int ply, const Move& ttMove) {
     int seeScore;
+    const SearchStackEntry* ss = stackAt(ply);
 
     // TT + PV
     if (Move::SameMove(ttMove, move)) return move_scores.TT_BASE;
-    if (ply < (int)previousPV.size() && Move::SameMove(move, previousPV[ply])) return move_scores.PV_BASE;
+    if (!ss->pv_move.IsNull() && Move::SameMove(move, ss->pv_move)) return move_scores.PV_BASE;
 
     // promotions
     if (move.IsPromotion()) {
@@ -133,8 +154,8 @@ int Searcher::moveScore(const Move& move, const Board& boardRef,
     }
 
     // killer moves
-    if (Move::SameMove(killerMoves[ply][0], move)) return move_scores.KILLER_BASE;
-    if (Move::SameMove(killerMoves[ply][1], move)) return move_scores.KILLER_BASE - 1;
+    if (Move::SameMove(ss->killers[0], move)) return move_scores.KILLER_BASE;
+    if (Move::SameMove(ss->killers[1], move)) return move_scores.KILLER_BASE - 1;
 
     // quiet moves (history heuristic)
     int piece = boardRef.getMovedPiece(move.StartSquare());
@@ -145,7 +166,7 @@ int Searcher::moveScore(const Move& move, const Board& boardRef,
 
 void Searcher::orderedMoves(Move moves[MAX_MOVES], size_t count,
                             const Board& boardRef, int ply, 
-                            const Move ttMove, const std::vector<Move>& previousPV) {
+                            const Move ttMove) {
     
     #ifdef DEV
         ScopedTimer timer(T_SCORE_ORDER);
@@ -155,7 +176,7 @@ void Searcher::orderedMoves(Move moves[MAX_MOVES], size_t count,
     // sorting
     std::pair<int, Move> scored[MAX_MOVES];
     for (size_t i = 0; i < count; ++i)
-        scored[i] = {moveScore(moves[i], boardRef, ply, ttMove, previousPV), moves[i]};
+        scored[i] = {moveScore(moves[i], boardRef, ply, ttMove), moves[i]};
 
     std::sort(scored, scored + count,
               [](const auto& a, const auto& b) { return a.first > b.first; });
@@ -163,11 +184,11 @@ void Searcher::orderedMoves(Move moves[MAX_MOVES], size_t count,
     for (size_t i = 0; i < count; ++i) moves[i] = scored[i].second;
 }
 
-int Searcher::generateAndOrderMoves(Move moves[MAX_MOVES], int ply, const Move ttMove, const std::vector<Move>& previousPV) {
+int Searcher::generateAndOrderMoves(Move moves[MAX_MOVES], int ply, const Move ttMove) {
     int count = movegen.generateMoves(board, false); // the bool flag for captures-only or not — adapt if signature differs
     std::copy_n(movegen.moves, count, moves);
 
-    orderedMoves(moves, static_cast<size_t>(count), board, ply, ttMove, previousPV);
+    orderedMoves(moves, static_cast<size_t>(count), board, ply, ttMove);
     
     return count;
 }
@@ -176,11 +197,14 @@ int Searcher::generateAndOrderMoves(Move moves[MAX_MOVES], int ply, const Move t
 // QUIESCENCE SEARCH
 // ============================================================================
 
-int Searcher::quiescence(int alpha, int beta, PV& pv, SearchLimits& limits, int ply, int depth, int search_depth) {
+int Searcher::quiescence(int alpha, int beta, SearchLimits& limits, int ply, int depth, int search_depth) {
+    pv_length[ply] = 0;
+    limits.count_node(ply);
     if (limits.out_of_time()) return alpha;
+    if (ply >= MAX_PLY) return board.is_in_check ? 0 : nnue.evaluate(board.is_white_move);
 
     // draw detection
-    if (board.isThreefold() || board.currentGameState.fiftyMoveCounter >= 50) {
+    if (board.isRepetition(ply) || board.currentGameState.fiftyMoveCounter >= 50) {
         //tt.store(board.zobrist_hash, depth, ply, 0, EXACT, Move::NullMove());
         return params.DRAW_EVAL;
     }
@@ -220,6 +244,8 @@ int Searcher::quiescence(int alpha, int beta, PV& pv, SearchLimits& limits, int
     Move moves[MAX_MOVES];
     if (count == 0) {
         if (board.is_in_check) { return -MATE_SCORE + ply; }
+        // no captures: stalemate if there is no quiet move either (early-exit query, same movegen state)
+        if (!movegen.hasLegalMoves()) return 0;
         return standPat;
     }
     std::copy_n(movegen.moves, count, moves);
@@ -237,8 +263,7 @@ int Searcher::quiescence(int alpha, int beta, PV& pv, SearchLimits& limits, int
         nnue.on_make_move(board, m);
         board.MakeMove(m);
 
-        int score; PV childPV;
-        score = -quiescence(-beta, -alpha, childPV, limits, ply+1, depth, search_depth);
+        int score = -quiescence(-beta, -alpha, limits, ply+1, depth, search_depth);
 
         // Undo board & NNUE (capture before must be reconstructed from states)
         nnue.on_unmake_move(board, m);
@@ -254,7 +279,7 @@ int Searcher::quiescence(int alpha, int beta, PV& pv, SearchLimits& limits, int
             bestEval = score;
             bestMove = m;
             alpha = std::max(alpha, score);
-            pv.set(m, childPV);
+            updatePV(ply, m, true);
         }
     }
 
@@ -269,26 +294,34 @@ int Searcher::quiescence(int alpha, int beta, PV& pv, SearchLimits& limits, int
 // NEGAMAX SEARCH
 // ============================================================================
 
-int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
-                      std::vector<Move>& previousPV, SearchLimits& limits, int ply, 
-                      bool can_nmp) {
+int Searcher::negamax(int depth, int alpha, int beta, SearchLimits& limits, int ply) {
+    pv_length[ply] = 0;
+    SearchStackEntry* ss = stackAt(ply);
 
     #ifdef DEV
         STATS_NODE(depth+ply, ply); // track node per depth
     #else 
         g_stats.nodes++;
     #endif 
+    limits.count_node(ply);
     if (limits.out_of_time()) return alpha;
+    if (ply >= MAX_PLY) return board.is_in_check ? 0 : nnue.evaluate(board.is_white_move);
 
     // --- end of search conditions ---
 
-    if (board.isThreefold() || board.currentGameState.fiftyMoveCounter >= 50) {
+    if (board.isRepetition(ply) || board.currentGameState.fiftyMoveCounter >= 50) {
         //tt.store(board.zobrist_hash, depth, ply, 0, EXACT, Move::NullMove());
         return params.DRAW_EVAL;
     }
 
+    // --- mate distance pruning ---
+    // nothing below can beat mating on the next move or do worse than being mated here
+    alpha = std::max(alpha, -(MATE_SCORE - ply));
+    beta = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta) return alpha;
+
     if (depth == 0) {
-        return quiescence(alpha, beta, pv, limits, ply, depth, ply);
+        return quiescence(alpha, beta, limits, ply, depth, ply);
     }
 
     // --- TT probe ---
@@ -310,7 +343,7 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
                 STATS_TT_RETURN(depth+ply, ply);
             #endif 
 
-            int ttScore = ttEntry->eval;
+            int ttScore = scoreFromTT(ttEntry->eval, ply);
             if (ttEntry->flag == EXACT) return ttScore;
             else if (ttEntry->flag == UPPERBOUND && ttScore <= alpha) return ttScore;
             else if (ttEntry->flag == LOWERBOUND && ttScore >= beta)  return ttScore;
@@ -325,11 +358,10 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
         #ifdef DEV
             STATS_IID(depth+ply, ply);
         #endif 
-        PV iidPV;
 
         // no flip in negamax func call cause we are not making a move yet (+ dont save eval)
         // currently, scaled reduction
-        negamax(depth * params.R_IID, alpha, beta, iidPV, previousPV, limits, ply, can_nmp);
+        negamax(depth * params.R_IID, alpha, beta, limits, ply);
         
         ttEntry = tt.probe(board.zobrist_hash);
         if (ttEntry && ttEntry->key == board.zobrist_hash) {
@@ -338,6 +370,10 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
     }
     */
 
+    // --- node state (read by the children through ss - 1) ---
+    ss->in_check = board.is_in_check;
+    ss->static_eval = ss->in_check ? SearchStackEntry::EVAL_NONE : nnue.evaluate(board.is_white_move);
+
     // -----------------------------
     // Null Move Pruning
     // -----------------------------
@@ -350,26 +386,26 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
         (depth - params.R_NMP > 0)
         &&
         // 2x null-moves not allowed
-        can_nmp
+        !(ss - 1)->move.IsNull()
         && 
         // board conditions (not in-check .. not pawn-endgame)
         !(
-            board.is_in_check 
-            || board.pawn_endgame 
+            ss->in_check 
+            || board.pawnEndgame() 
         )
         && 
         // static eval > beta
-        (nnue.evaluate(board.is_white_move) > beta)
+        (ss->static_eval > beta)
     ) {
         #ifdef DEV
             ScopedTimer timer(T_NMP_SEARCH);
             STATS_NMP(depth+ply, ply);
         #endif
-        PV emptyPV;
-
         // null moves just change the side to move (and last-move cache)
+        ss->move = Move::NullMove();
+        ss->reduction = 0;
         board.MakeNullMove();
-        int null_score = -negamax(depth - params.R_NMP, -beta, -(beta - 1), emptyPV, previousPV, limits, ply + 1, false);
+        int null_score = -negamax(depth - params.R_NMP, -beta, -(beta - 1), limits, ply + 1);
         board.UnmakeNullMove();
 
         // null window around beta so if if null move fails high 
@@ -385,16 +421,17 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
     // --- search ---
 
     Move moves[MAX_MOVES];
-    int count = generateAndOrderMoves(moves, ply, ttMove, previousPV);
-    if (count == 0) return board.is_in_check ? -(MATE_SCORE - ply) : 0;
+    int count = generateAndOrderMoves(moves, ply, ttMove);
+    if (count == 0) return ss->in_check ? -(MATE_SCORE - ply) : 0;
 
     int bestEval = -MATE_SCORE;
     Move bestMove = Move::NullMove();
 
     int _lmr_R = 0;
 
-    bool in_check, is_pawn_endgame, was_capture, is_capture;
-    Move m; int score; PV childPV; PV emptyPV;
+    bool is_capture;
+    Move m; int score;
+    bool child_line; // last search of m was a PV search, so pv_table[ply + 1] is its line
 
     // --- move loop ---
 
@@ -404,16 +441,13 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
         m = moves[i];
 
         // current board state info
-        in_check = board.is_in_check;
-        is_pawn_endgame = board.pawn_endgame;
-        was_capture = board.currentGameState.capturedPieceType != -1;
         is_capture = board.getCapturedPiece(m.TargetSquare()) != -1;
 
         // Apply NNUE/update & board
         nnue.on_make_move(board, m);
         board.MakeMove(m);
         
-        score = 0; childPV = {}; emptyPV = {};
+        score = 0; child_line = false;
 
         // -----------------------------
         // Late Move Reduction
@@ -427,18 +461,20 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
             // positional conditions apply
             !is_capture
             && !m.IsPromotion()
-            && !in_check
+            && !ss->in_check
         ) {
             // obsidian log formula
             _lmr_R = R_lmr(depth, i);
         } else {
             _lmr_R = 0;
         }
+        ss->move = m;
+        ss->reduction = _lmr_R;
 
-        //score = -negamax(depth - 1 - _lmr_R, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+        //score = -negamax(depth - 1 - _lmr_R, -beta, -alpha, limits, ply + 1);
         //if (_lmr_R > 0 && score > alpha) {
         //    childPV = {}; // dont let teh reduced-search line leak into the full-depth result
-        //    score = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply+1, true);
+        //    score = -negamax(depth - 1, -beta, -alpha, limits, ply+1);
         //}
 
         // -----------------------------
@@ -450,11 +486,12 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
         // else it fails low and is not going to be a better move than what has been found
         // null window searches are cheap and so the re-searches are worth the speedup
         if (i == 0) {
-            score = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+            score = -negamax(depth - 1, -beta, -alpha, limits, ply + 1);
+            child_line = true;
         } else {
             // null-window search
             // lmr =0 OR >0
-            score = -negamax(depth - 1 - _lmr_R, -(alpha+1), -alpha, emptyPV, previousPV, limits, ply + 1, true);
+            score = -negamax(depth - 1 - _lmr_R, -(alpha+1), -alpha, limits, ply + 1);
 
             // if lmr_r > 0 then re-search with null-window at full depth
             // if score > alpha from this re-search,
@@ -464,8 +501,7 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
                 #ifdef DEV
                     STATS_PVS_RESEARCH(depth+ply, ply, 0);
                 #endif
-                emptyPV = {};
-                score = -negamax(depth - 1, -(alpha+1), -alpha, emptyPV, previousPV, limits, ply + 1, true);
+                score = -negamax(depth - 1, -(alpha+1), -alpha, limits, ply + 1);
             }
 
             // if lmr_R == 0 then search with null window
@@ -476,8 +512,8 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
                 #ifdef DEV
                     STATS_PVS_RESEARCH(depth+ply, ply, 1);
                 #endif
-                emptyPV = {};
-                score = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+                score = -negamax(depth - 1, -beta, -alpha, limits, ply + 1);
+                child_line = true;
             }
         }
 
@@ -488,7 +524,7 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
         if (score > bestEval) {
             bestEval = score;
             bestMove = m;
-            pv.set(m, childPV);
+            updatePV(ply, m, child_line);
         }
 
         alpha = std::max(alpha, bestEval);
@@ -497,10 +533,10 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
                 STATS_FAILHIGH(depth+ply, ply, i);
             #endif
 
-            if (!Move::SameMove(killerMoves[ply][0], m) && !m.IsPromotion() &&
+            if (!Move::SameMove(ss->killers[0], m) && !m.IsPromotion() &&
                 !(1ULL << m.TargetSquare() & board.colorBitboards[1 - board.move_color])) {
-                killerMoves[ply][1] = killerMoves[ply][0];
-                killerMoves[ply][0] = m;
+                ss->killers[1] = ss->killers[0];
+                ss->killers[0] = m;
             }
             int piece = board.getMovedPiece(m.StartSquare());
             historyHeuristic[board.is_white_move ? piece : piece + 6][m.TargetSquare()] += depth * depth;
@@ -510,6 +546,10 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
 
     // --- tt-store ---
 
+    // a stop left this node half-searched (bestEval can still be -MATE_SCORE when it
+    // latched inside the null-move search): the caller discards the score, never store it
+    if (limits.out_of_time()) return alpha;
+
     BoundType flag = EXACT;
     if (bestEval <= alphaOrig) { 
         flag = UPPERBOUND; 
@@ -530,7 +570,7 @@ int Searcher::negamax(int depth, int alpha, int beta, PV& pv,
 // ROOT SEARCH
 // ============================================================================
 
-SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int depth, SearchLimits& limits, std::vector<Move>& previousPV, int previousEval) {
+SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int depth, SearchLimits& limits, const std::vector<Move>& previousPV, int previousEval) {
     int eval;
     int ply = 0; // root moves are depth=0, ply+1 in arg call makes made moves depth=1
     SearchResult result;
@@ -540,10 +580,15 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
 
     // current board state info
     bool in_check = board.is_in_check;
-    bool is_pawn_endgame = board.pawn_endgame;
-    bool was_capture = board.currentGameState.capturedPieceType != -1;
     bool is_capture;
 
+    // --- search stack: root entry + the last iteration's PV for move ordering ---
+    for (int p = 0; p < MAX_PLY; ++p)
+        stackAt(p)->pv_move = p < static_cast<int>(previousPV.size()) ? previousPV[p] : Move::NullMove();
+    SearchStackEntry* ss = stackAt(ply);
+    ss->in_check = in_check;
+    ss->static_eval = SearchStackEntry::EVAL_NONE;
+
     // --- aspiration search ---
     
     int delta = params.ASPIRATION_WINDOW;
@@ -562,6 +607,8 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
         g_stats.nodes++;
     #endif   
 
+    int fail_lows = 0;
+
     // root move loop for both aspiration + regular search
     while (true) {
         SearchResult iter_result;
@@ -570,7 +617,8 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
 
         // explore (our) root moves
         for (int i = 0; i < count; ++i) {
-            if (limits.out_of_time()) break;
+            // the first move is always searched, so even an immediate stop returns a legal move
+            if (i > 0 && limits.out_of_time()) break;
             Move m = root_moves[i].move;
             if (Move::SameMove(m, Move::NullMove())) continue;
 
@@ -584,7 +632,6 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
             nnue.on_make_move(board, m);
             board.MakeMove(m);
   
-            PV childPV; PV emptyPV; // must be declared per root_move
 
             // --- LMR ---
             is_capture = board.getCapturedPiece(m.TargetSquare()) != -1;
@@ -600,21 +647,23 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
             } else {
                 _lmr_R = 0;
             }
+            ss->move = m;
+            ss->reduction = _lmr_R;
             
-            //eval = -negamax(depth - 1 - _lmr_R, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+            //eval = -negamax(depth - 1 - _lmr_R, -beta, -alpha, limits, ply + 1);
             //if (_lmr_R > 0 && eval > alpha) { // research at full depth if move raises alpha
             //    childPV = {};   // don't let the reduced-search line leak into the full-depth result
-            //    eval = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply+1, true);
+            //    eval = -negamax(depth - 1, -beta, -alpha, limits, ply+1);
             //}
 
             // --- PVS ---
             if (i == 0) {
-                eval = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+                eval = -negamax(depth - 1, -beta, -alpha, limits, ply + 1);
                 exact = true;
             } else {
                 // null-window search
                 // lmr =0 OR >0
-                eval = -negamax(depth - 1 - _lmr_R, -(alpha+1), -alpha, emptyPV, previousPV, limits, ply + 1, true);
+                eval = -negamax(depth - 1 - _lmr_R, -(alpha+1), -alpha, limits, ply + 1);
 
                 // if lmr_r > 0 then re-search with null-window at full depth
                 // if score > alpha from this re-search,
@@ -624,8 +673,7 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
                     #ifdef DEV
                         STATS_PVS_RESEARCH(depth+ply, ply, 0); // lmr
                     #endif
-                    emptyPV = {};
-                    eval = -negamax(depth - 1, -(alpha+1), -alpha, emptyPV, previousPV, limits, ply + 1, true);
+                    eval = -negamax(depth - 1, -(alpha+1), -alpha, limits, ply + 1);
                 }
 
                 // if lmr_R == 0 then search with null window
@@ -636,8 +684,7 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
                     #ifdef DEV
                         STATS_PVS_RESEARCH(depth+ply, ply, 2); // root full
                     #endif
-                    emptyPV = {};
-                    eval = -negamax(depth - 1, -beta, -alpha, childPV, previousPV, limits, ply + 1, true);
+                    eval = -negamax(depth - 1, -beta, -alpha, limits, ply + 1);
                     exact = true;
                 }
             }
@@ -652,7 +699,8 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
             #endif
 
             // time out is propagated up the tree, so eval and move cannot be trusted
-            if (limits.out_of_time() && i > 0) break;
+            // (an interrupted first move is only kept at depth 1, where there is no earlier result)
+            if (limits.out_of_time() && (i > 0 || depth > 1)) break;
 
             iter_result.root_moves[i].move = m;
             iter_result.root_moves[i].eval = eval;
@@ -664,7 +712,8 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
             if (i == 0 || eval > iter_result.eval) {
                 iter_result.eval = eval;
                 iter_result.bestMove = m;
-                iter_result.best_line.set(m, childPV); 
+                // exact = the last search of m was a PV search, so pv_table[1] is its line
+                iter_result.best_line.set(m, pv_table[1], exact ? pv_length[1] : 0);
             }
         }
 
@@ -674,6 +723,7 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
                 #ifdef DEV
                     STATS_ASPIRATION_FAILLOW(depth);
                 #endif
+                fail_lows++;
                 alpha = aspAlpha - delta;
                 beta = aspBeta;
                 delta *= params.ASPIRATION_RESEARCH_SCALE;
@@ -690,28 +740,93 @@ SearchResult Searcher::search(RootMove root_moves[MAX_MOVES], int count, int dep
         } 
 
         result = iter_result;
+        result.fail_lows = fail_lows;
         break;
     }
 
     return result;
 }
 
-SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_count, SearchLimits limits) {
+// MultiPV: one aspiration search per line over the root moves no better line has taken yet,
+// the line's best move then moves into its slot. Later lines re-search mostly from the TT.
+SearchResult Searcher::searchMultiPV(RootMove root_moves[MAX_MOVES], int count, int depth, SearchLimits& limits, const SearchResult& previous, int line_count) {
+    SearchResult result;
+    std::copy_n(root_moves, count, result.root_moves);
+    RootMove* moves = result.root_moves;
+
+    for (int pv_idx = 0; pv_idx < line_count; ++pv_idx) {
+        // window around the same line of the last iteration
+        const PVLine& prev = pv_idx < previous.line_count ? previous.lines[pv_idx] : previous.lines[0];
+        SearchResult line = search(moves + pv_idx, count - pv_idx, depth, limits, prev.line.line, prev.eval);
+
+        // an interrupted line cannot be trusted: keep the last full iteration instead
+        // (depth 1 keeps what it has, there is nothing earlier)
+        if (limits.out_of_time() && (depth > 1 || pv_idx > 0)) {
+            if (depth > 1) return SearchResult();
+            break;
+        }
+        if (Move::SameMove(line.bestMove, Move::NullMove())) return SearchResult();
+
+        for (int i = 0; i < count - pv_idx; ++i)
+            if (!Move::SameMove(line.root_moves[i].move, Move::NullMove())) moves[pv_idx + i] = line.root_moves[i];
+
+        RootMove* best = std::find_if(moves + pv_idx, moves + count,
+            [&](const RootMove& rm) { return Move::SameMove(rm.move, line.bestMove); });
+        std::rotate(moves + pv_idx, best, best + 1);
+        moves[pv_idx].eval = line.eval;
+        moves[pv_idx].exact = true;
+
+        result.lines[pv_idx].eval = line.eval;
+        result.lines[pv_idx].line = line.best_line;
+        result.line_count++;
+        if (pv_idx == 0) result.fail_lows = line.fail_lows;
+    }
+
+    // a later line can come back above an earlier one (search instability): rank by score
+    std::stable_sort(result.lines, result.lines + result.line_count,
+        [](const PVLine& a, const PVLine& b) { return a.eval > b.eval; });
+    std::stable_sort(moves, moves + result.line_count,
+        [](const RootMove& a, const RootMove& b) { return a.eval > b.eval; });
+
+    result.root_count = count;
+    result.bestMove = moves[0].move;
+    result.eval = result.lines[0].eval;
+    result.best_line = result.lines[0].line;
+    return result;
+}
+
+SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_count, SearchLimits& limits) {
     SearchResult last_result;
     SearchResult result;
 
     // nodes from prior iteration INIT
     std::fill(std::begin(node_count_table), std::end(node_count_table), 0);
+    tt.newSearch();
 
     int depth = 1;
     Move prevBest = Move::NullMove();
+    int prevEval = 0;
+    int stability = 0;                 // consecutive iterations with the same best move
+    uint64_t prev_iteration_nodes = 0;
 
     // Build NNUE accumulators for root position
     nnue.build_accumulators(board);
 
+    // fresh search stack for this root (killers are kept, like the history table)
+    for (SearchStackEntry& e : search_stack) {
+        e.move = e.pv_move = Move::NullMove();
+        e.static_eval = SearchStackEntry::EVAL_NONE;
+        e.reduction = 0;
+        e.in_check = false;
+    }
+
     // --- iterative deepening loop ---
-    while (!limits.should_stop(depth)) {
+    // depth 1 always runs (a stop that lands before the search still gets a legal bestmove)
+    while (depth == 1 || !limits.should_stop(depth)) {
         auto depth_start = std::chrono::steady_clock::now();
+        uint64_t nodes_start = limits.nodes;
+        limits.depth = depth;
+        limits.seldepth = 0;
         g_stats.max_depth = depth;
 
         // --- move ordering ---
@@ -749,7 +864,7 @@ SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_
                 #endif
                 ttMove = ttEntry->bestMove;
             }
-            orderedMoves(first_moves, move_count, board, 0, ttMove, {});
+            orderedMoves(first_moves, move_count, board, 0, ttMove);
 
             for (int i = 0; i < move_count; ++i) {
                 last_result.root_moves[i].move = first_moves[i];
@@ -757,8 +872,16 @@ SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_
         }
 
         // --- search ---
-        result = search(last_result.root_moves, move_count, depth, limits,
-                                     last_result.best_line.line, last_result.eval);
+        int line_count = std::min(multi_pv, move_count);
+        if (line_count > 1) {
+            result = searchMultiPV(last_result.root_moves, move_count, depth, limits, last_result, line_count);
+        } else {
+            result = search(last_result.root_moves, move_count, depth, limits,
+                                         last_result.best_line.line, last_result.eval);
+            result.lines[0].eval = result.eval;
+            result.lines[0].line = result.best_line;
+            result.line_count = 1;
+        }
 
 
         // --- store results ---
@@ -766,6 +889,7 @@ SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_
             last_result = result;
             store_last_node_counts(result);
             g_stats.max_completed_depth = depth; 
+            if (on_iteration) on_iteration(result, depth, limits);
         }
 
         // --- logging --- 
@@ -781,7 +905,30 @@ SearchResult Searcher::iterativeDeepening(Move first_moves[MAX_MOVES], int move_
             logRootMoves(result, depth);
         #endif
 
-        if (std::abs(result.eval) >= MATE_SCORE - 10) break;
+        // --- time management (game clock) ---
+        if (limits.soft_limit_ms > 0 && !limits.out_of_time()) {
+            stability = (depth > 1 && Move::SameMove(result.bestMove, prevBest)) ? stability + 1 : 0;
+            double scale = timeScale(result, stability, depth > 1 ? prevEval - result.eval : 0);
+
+            // next iteration ~ this one * effective branching factor
+            uint64_t iteration_nodes = limits.nodes - nodes_start;
+            double ebf = prev_iteration_nodes > 0
+                ? std::clamp(static_cast<double>(iteration_nodes) / static_cast<double>(prev_iteration_nodes), 1.0, static_cast<double>(params.TM_MAX_EBF))
+                : 2.0;
+            auto iteration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - depth_start).count();
+            prev_iteration_nodes = iteration_nodes;
+
+            if (limits.soft_stop(scale, static_cast<int64_t>(static_cast<double>(iteration_ms) * ebf))) break;
+        }
+        prevBest = result.bestMove;
+        prevEval = result.eval;
+
+        // go mate: done as soon as a short enough mate is proven (a deeper search only confirms it)
+        if (limits.mate > 0) {
+            if (limits.mate_found(result.eval)) break;
+        }
+        else if (std::abs(result.eval) >= MATE_SCORE - 10) break;
         depth++;
         // if only 1 legal move, perform depth 2 search then play move
         // depth 2 to get fair eval with recaptures, etc. (very fast)
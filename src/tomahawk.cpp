@@ -2,10 +2,10 @@
 #include <session.h>
 #include <engine.h>
 #include <board.h>
-#include <PrecomputedMoveData.h>
 #include <iostream>
 #include <atomic>
 #include <thread>
+#include <memory>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -81,12 +81,10 @@ int main() {
 
     // inits
     Logging::initFiles();
-    PrecomputedMoveData::init();
-    Magics::initMagics();
 
-    // engine
-    Engine engine;
-    UCI uci(engine);
+    // engine (heap: its boards carry inline history, ~680 KB - too big for a 1 MB Windows main stack)
+    auto engine = std::make_unique<Engine>();
+    UCI uci(*engine);
 
     // uci loop
     std::thread listener([&uci](){